@@ -0,0 +1,304 @@
+ /**
+ **************************************************************
+ * @file host/cag_link.c
+ * @author Sami Kaab - s4375116
+ * @date 19102026
+ * @brief Talk to the board over the framed protocol of s4375116_CAG_proto
+ * Runs over the same serial port as the cli, text from the board is skipped.
+ *  ping                 round trip time
+ *  upload grid.pbm      replace the board's grid (PBM, P1 or P4, the size of the grid)
+ *  download grid.pbm    save the board's grid
+ *  stream [frames]      show every displayed generation on this terminal
+ *  cmd type [x y]       send a simulator command (CA_CMD_* in s4375116_CAG_simulator.h)
+ * usage: cag_link [-d device] [-b baud] command [args]
+ ***************************************************************
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/select.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "s4375116_CAG_proto.h"
+#include "s4375116_CAG_term.h"
+
+#define REPLY_TIMEOUT_MS	1000
+#define MAX_CELLS			(CAG_TERM_MAX_WIDTH * CAG_TERM_MAX_HEIGHT)
+
+static int port = -1;
+static CagProtoParser parser;
+
+static double now_ms(void) {
+
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+/**
+ * @brief Open the serial port raw, 8N1
+ *
+ */
+static int open_port(const char *device, int baud) {
+
+	struct termios tio;
+	speed_t speed;
+
+	switch (baud) {
+		case 9600: speed = B9600; break;
+		case 57600: speed = B57600; break;
+		case 115200: speed = B115200; break;
+		case 230400: speed = B230400; break;
+		case 460800: speed = B460800; break;
+		case 921600: speed = B921600; break;
+		default: return -1;
+	}
+
+	port = open(device, O_RDWR | O_NOCTTY);
+	if (port < 0 || tcgetattr(port, &tio) < 0) {
+		return -1;
+	}
+	cfmakeraw(&tio);
+	cfsetispeed(&tio, speed);
+	cfsetospeed(&tio, speed);
+	tio.c_cflag |= CLOCAL | CREAD;
+	tio.c_cc[VMIN] = 0;
+	tio.c_cc[VTIME] = 0;
+	return tcsetattr(port, TCSANOW, &tio);
+}
+
+static void send_frame(int type, const uint8_t *payload, int len) {
+
+	uint8_t frame[CAG_PROTO_MAX_FRAME];
+
+	len = s4375116_lib_cag_proto_encode(frame, type, payload, len);
+	if (write(port, frame, len) != len) {
+		perror("write");
+	}
+}
+
+/**
+ * @brief Wait for a frame of the given type, anything else is skipped
+ *
+ * @param type expected type
+ * @param timeoutMs longest wait, negative waits forever
+ * @return int 0 with the frame in parser, -1 on timeout
+ */
+static int wait_frame(int type, int timeoutMs) {
+
+	double deadline = now_ms() + timeoutMs;
+	struct timeval tv;
+	fd_set fds;
+	uint8_t buf[256];
+	int n;
+
+	for (;;) {
+		FD_ZERO(&fds);
+		FD_SET(port, &fds);
+		tv.tv_sec = 0;
+		tv.tv_usec = 10000;
+		if (select(port + 1, &fds, NULL, NULL, &tv) > 0) {
+			n = read(port, buf, 1);	// a byte at a time, the rest stays for the next frame
+			for (int i = 0; i < n; i++) {
+				if (s4375116_lib_cag_proto_feed(&parser, buf[i]) == CAG_PROTO_FRAME && parser.type == type) {
+					return 0;
+				}
+			}
+		}
+		if (timeoutMs >= 0 && now_ms() > deadline) {
+			return -1;
+		}
+	}
+}
+
+/**
+ * @brief Send a frame and wait for its ack
+ *
+ * @return int ack status, -1 if none came
+ */
+static int request(int type, const uint8_t *payload, int len) {
+
+	send_frame(type, payload, len);
+	while (wait_frame(CAG_PROTO_ACK, REPLY_TIMEOUT_MS) == 0) {
+		if (parser.length == 2 && parser.payload[0] == type) {
+			return parser.payload[1];
+		}
+	}
+	return -1;
+}
+
+/**
+ * @brief Read a PBM image (P1 or P4) as cells, 1 is alive
+ *
+ */
+static int read_pbm(const char *path, char *cells, int *width, int *height) {
+
+	FILE *f = fopen(path, "rb");
+	char magic[3] = {0};
+	int c;
+	int byte = 0;
+
+	if (f == NULL || fscanf(f, "%2s %d %d", magic, width, height) != 3 || *width * *height > MAX_CELLS ||
+			*width <= 0 || *height <= 0 || (strcmp(magic, "P1") != 0 && strcmp(magic, "P4") != 0)) {
+		return -1;
+	}
+	fgetc(f);	// the single white space before the raster
+
+	for (int y = 0; y < *height; y++) {
+		for (int x = 0; x < *width; x++) {
+			if (magic[1] == '4') {
+				if ((x % 8) == 0 && (byte = fgetc(f)) == EOF) {
+					return -1;
+				}
+				cells[y * *width + x] = (byte >> (7 - (x % 8))) & 1;
+			} else {
+				while ((c = fgetc(f)) != EOF && c != '0' && c != '1');
+				if (c == EOF) {
+					return -1;
+				}
+				cells[y * *width + x] = (c == '1');
+			}
+		}
+	}
+	fclose(f);
+	return 0;
+}
+
+static int write_pbm(const char *path, const char *cells, int width, int height) {
+
+	FILE *f = fopen(path, "wb");
+	uint8_t byte;
+
+	if (f == NULL) {
+		return -1;
+	}
+	fprintf(f, "P4\n%d %d\n", width, height);
+	for (int y = 0; y < height; y++) {
+		byte = 0;
+		for (int x = 0; x < width; x++) {
+			byte |= cells[y * width + x] << (7 - (x % 8));
+			if ((x % 8) == 7 || x == width - 1) {
+				fputc(byte, f);
+				byte = 0;
+			}
+		}
+	}
+	fclose(f);
+	return 0;
+}
+
+static void term_stdout_write(const char *buf, int len) {
+
+	fwrite(buf, 1, len, stdout);
+	fflush(stdout);
+}
+
+static void usage(const char *name) {
+	fprintf(stderr, "usage: %s [-d device] [-b baud] ping | upload grid.pbm | download grid.pbm | stream [frames] | cmd type [x y]\n", name);
+}
+
+int main(int argc, char **argv) {
+
+	const char *device = "/dev/ttyACM0";
+	int baud = 115200;
+	int opt;
+	int status;
+	int width;
+	int height;
+	int frames;
+	uint32_t generation;
+	uint8_t payload[CAG_PROTO_MAX_PAYLOAD];
+	char cells[MAX_CELLS];
+	char text[CAG_TERM_STATUS_MAX + 1];
+	double start;
+	const char *cmd;
+
+	while ((opt = getopt(argc, argv, "+d:b:")) != -1) {
+		switch (opt) {
+			case 'd':
+				device = optarg;
+				break;
+			case 'b':
+				baud = atoi(optarg);
+				break;
+			default:
+				usage(argv[0]);
+				return 1;
+		}
+	}
+	if (optind >= argc) {
+		usage(argv[0]);
+		return 1;
+	}
+	cmd = argv[optind];
+
+	if (open_port(device, baud) < 0) {
+		fprintf(stderr, "%s: %s\n", device, (errno != 0) ? strerror(errno) : "unsupported baud rate");
+		return 1;
+	}
+	s4375116_lib_cag_proto_reset(&parser);
+	start = now_ms();
+
+	if (strcmp(cmd, "ping") == 0) {
+		status = request(CAG_PROTO_PING, NULL, 0);
+
+	} else if (strcmp(cmd, "upload") == 0 && optind + 1 < argc) {
+		if (read_pbm(argv[optind + 1], cells, &width, &height) < 0 || CAG_PROTO_GRID_SIZE(width, height) > CAG_PROTO_MAX_PAYLOAD) {
+			fprintf(stderr, "%s: not a PBM image of at most %d cells\n", argv[optind + 1], (CAG_PROTO_MAX_PAYLOAD - CAG_PROTO_GRID_HEADER) * 8);
+			return 1;
+		}
+		status = request(CAG_PROTO_UPLOAD, payload, s4375116_lib_cag_proto_pack_grid(payload, cells, width, height, 0));
+
+	} else if (strcmp(cmd, "download") == 0 && optind + 1 < argc) {
+		send_frame(CAG_PROTO_DOWNLOAD, NULL, 0);
+		status = -1;
+		if (wait_frame(CAG_PROTO_GRID, REPLY_TIMEOUT_MS) == 0 &&
+				s4375116_lib_cag_proto_unpack_grid(parser.payload, parser.length, cells, MAX_CELLS, &width, &height, &generation) == 0) {
+			status = write_pbm(argv[optind + 1], cells, width, height) < 0 ? CAG_PROTO_ERR_BUSY : CAG_PROTO_OK;
+			printf("%dx%d grid, generation %u\n", width, height, generation);
+		}
+
+	} else if (strcmp(cmd, "stream") == 0) {
+		frames = (optind + 1 < argc) ? atoi(argv[optind + 1]) : -1;
+		payload[0] = 1;
+		if ((status = request(CAG_PROTO_STREAM, payload, 1)) == CAG_PROTO_OK) {
+			s4375116_lib_cag_term_init(term_stdout_write);
+			while (frames != 0 && wait_frame(CAG_PROTO_GRID, -1) == 0) {
+				if (s4375116_lib_cag_proto_unpack_grid(parser.payload, parser.length, cells, MAX_CELLS, &width, &height, &generation) == 0) {
+					snprintf(text, sizeof(text), "G:%u", generation);
+					s4375116_lib_cag_term_render(cells, width, height, text);
+					frames--;
+				}
+			}
+			s4375116_lib_cag_term_release();
+			payload[0] = 0;
+			status = request(CAG_PROTO_STREAM, payload, 1);
+		}
+
+	} else if (strcmp(cmd, "cmd") == 0 && optind + 1 < argc) {
+		int type = strtol(argv[optind + 1], NULL, 0);
+		int x = (optind + 2 < argc) ? atoi(argv[optind + 2]) : 0;
+		int y = (optind + 3 < argc) ? atoi(argv[optind + 3]) : 0;
+		uint8_t args[5] = {type, x & 0xFF, (x >> 8) & 0xFF, y & 0xFF, (y >> 8) & 0xFF};
+		status = request(CAG_PROTO_COMMAND, args, sizeof(args));
+
+	} else {
+		usage(argv[0]);
+		return 1;
+	}
+
+	if (status < 0) {
+		fprintf(stderr, "%s: no answer from the board\n", cmd);
+		return 1;
+	}
+	printf("%s: %s in %.1f ms\n", cmd, (status == CAG_PROTO_OK) ? "ok" : "refused", now_ms() - start);
+	close(port);
+	return status != CAG_PROTO_OK;
+}
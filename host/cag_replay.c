@@ -0,0 +1,337 @@
+ /**
+ **************************************************************
+ * @file host/cag_replay.c
+ * @author Sami Kaab - s4375116
+ * @date 19102026
+ * @brief Decode a game of life recording into an animated GIF or a PBM sequence
+ * Reads a binary recording (oled_bench -r) or the hex lines printed by the
+ * 'rec dump' cli command, any other lines of a captured terminal log are ignored.
+ * -a plays the recording on this terminal with s4375116_CAG_term, as 'term on' does on the board.
+ * usage: cag_replay [-a] [-g out.gif] [-p frame_prefix] [-s scale] [-t delay_cs] recording
+ ***************************************************************
+ */
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "s4375116_CAG_recorder.h"
+#include "s4375116_CAG_term.h"
+
+#define LZW_MIN_CODE_SIZE	2	// smallest the GIF format allows, only colours 0 and 1 are used
+#define LZW_CLEAR			(1 << LZW_MIN_CODE_SIZE)
+#define LZW_MAX_CODE		4095
+
+/* GIF image data writer, codes are packed LSB first into sub-blocks of up to 255 bytes */
+struct gifWriter {
+	FILE *f;
+	uint32_t bitBuf;
+	int bitCount;
+	uint8_t block[255];
+	int blockLen;
+	uint16_t next[LZW_MAX_CODE + 1][2];	// LZW dictionary, code of (prefix, pixel)
+};
+
+/**
+ * @brief Read a whole recording, hex lines are converted back to bytes
+ *
+ * @param path file to read
+ * @param len returns the number of bytes
+ * @return uint8_t* recording, or NULL on error
+ */
+static uint8_t *read_recording(const char *path, int *len) {
+
+	FILE *f = fopen(path, "rb");
+	uint8_t *data;
+	char line[512];
+	int size = 0;
+	int cap = 4096;
+	int n;
+	size_t i;
+
+	if (f == NULL) {
+		return NULL;
+	}
+	data = malloc(cap);
+
+	n = fread(data, 1, CAG_RECORDER_HEADER_SIZE, f);
+	if (n == CAG_RECORDER_HEADER_SIZE && memcmp(data, "CAGR", 4) == 0) {	// binary recording
+		size = n;
+		while ((n = fread(data + size, 1, cap - size, f)) > 0) {
+			size += n;
+			if (size == cap) {
+				cap *= 2;
+				data = realloc(data, cap);
+			}
+		}
+	} else {	// terminal log, keep only lines made of hex digit pairs
+		rewind(f);
+		while (fgets(line, sizeof(line), f) != NULL) {
+			line[strcspn(line, "\r\n")] = '\0';
+			for (i = 0; isxdigit((unsigned char) line[i]); i++);
+			if (i == 0 || line[i] != '\0' || (i % 2) != 0) {
+				continue;
+			}
+			if (size + (int) i / 2 > cap) {
+				cap *= 2;
+				data = realloc(data, cap);
+			}
+			for (i = 0; line[i] != '\0'; i += 2) {
+				sscanf(&line[i], "%2hhx", &data[size++]);
+			}
+		}
+	}
+
+	fclose(f);
+	*len = size;
+	return data;
+}
+
+/**
+ * @brief Terminal output of the -a option
+ *
+ */
+static void term_stdout_write(const char *buf, int len) {
+
+	fwrite(buf, 1, len, stdout);
+	fflush(stdout);
+}
+
+/**
+ * @brief Write a frame as a binary PBM image
+ *
+ */
+static int write_pbm(const char *path, const char *cells, int width, int height, int scale) {
+
+	FILE *f = fopen(path, "wb");
+	uint8_t byte;
+
+	if (f == NULL) {
+		return -1;
+	}
+	fprintf(f, "P4\n%d %d\n", width * scale, height * scale);
+	for (int y = 0; y < height * scale; y++) {
+		byte = 0;
+		for (int x = 0; x < width * scale; x++) {
+			byte |= cells[(y / scale) * width + x / scale] << (7 - (x % 8));
+			if ((x % 8) == 7 || x == width * scale - 1) {
+				fputc(byte, f);
+				byte = 0;
+			}
+		}
+	}
+	fclose(f);
+	return 0;
+}
+
+static void gif_put_code(struct gifWriter *gif, int code, int codeSize) {
+
+	gif->bitBuf |= (uint32_t) code << gif->bitCount;
+	gif->bitCount += codeSize;
+	while (gif->bitCount >= 8) {
+		gif->block[gif->blockLen++] = gif->bitBuf & 0xFF;
+		gif->bitBuf >>= 8;
+		gif->bitCount -= 8;
+		if (gif->blockLen == sizeof(gif->block)) {
+			fputc(gif->blockLen, gif->f);
+			fwrite(gif->block, 1, gif->blockLen, gif->f);
+			gif->blockLen = 0;
+		}
+	}
+}
+
+/**
+ * @brief Write the GIF header, a black and white palette and the loop forever extension
+ *
+ */
+static void gif_begin(struct gifWriter *gif, int width, int height) {
+
+	static const uint8_t palette[6] = {0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF};
+	static const uint8_t loop[19] = {0x21, 0xFF, 0x0B, 'N', 'E', 'T', 'S', 'C', 'A', 'P', 'E',
+			'2', '.', '0', 0x03, 0x01, 0x00, 0x00, 0x00};
+
+	fwrite("GIF89a", 1, 6, gif->f);
+	fputc(width & 0xFF, gif->f);
+	fputc(width >> 8, gif->f);
+	fputc(height & 0xFF, gif->f);
+	fputc(height >> 8, gif->f);
+	fputc(0x80, gif->f);	// global colour table of 2 entries
+	fputc(0, gif->f);
+	fputc(0, gif->f);
+	fwrite(palette, 1, sizeof(palette), gif->f);
+	fwrite(loop, 1, sizeof(loop), gif->f);
+}
+
+/**
+ * @brief Append a frame to the GIF, LZW compressed
+ *
+ */
+static void gif_frame(struct gifWriter *gif, const char *cells, int width, int height, int scale, int delay) {
+
+	int w = width * scale;
+	int h = height * scale;
+	int codeSize = LZW_MIN_CODE_SIZE + 1;
+	int maxCode = LZW_CLEAR + 1;
+	int curr = -1;
+	int pixel;
+	const uint8_t header[8] = {0x21, 0xF9, 0x04, 0x00, delay & 0xFF, delay >> 8, 0x00, 0x00};
+
+	fwrite(header, 1, sizeof(header), gif->f);
+	fputc(0x2C, gif->f);	// image descriptor covering the whole screen
+	fputc(0, gif->f);
+	fputc(0, gif->f);
+	fputc(0, gif->f);
+	fputc(0, gif->f);
+	fputc(w & 0xFF, gif->f);
+	fputc(w >> 8, gif->f);
+	fputc(h & 0xFF, gif->f);
+	fputc(h >> 8, gif->f);
+	fputc(0, gif->f);
+	fputc(LZW_MIN_CODE_SIZE, gif->f);
+
+	gif->bitBuf = 0;
+	gif->bitCount = 0;
+	gif->blockLen = 0;
+	memset(gif->next, 0, sizeof(gif->next));
+	gif_put_code(gif, LZW_CLEAR, codeSize);
+
+	for (int y = 0; y < h; y++) {
+		for (int x = 0; x < w; x++) {
+			pixel = cells[(y / scale) * width + x / scale];
+			if (curr < 0) {
+				curr = pixel;
+			} else if (gif->next[curr][pixel] != 0) {
+				curr = gif->next[curr][pixel];
+			} else {
+				gif_put_code(gif, curr, codeSize);
+				gif->next[curr][pixel] = ++maxCode;
+				if (maxCode >= (1 << codeSize)) {
+					codeSize++;
+				}
+				if (maxCode == LZW_MAX_CODE) {	// dictionary full, start again
+					gif_put_code(gif, LZW_CLEAR, codeSize);
+					memset(gif->next, 0, sizeof(gif->next));
+					codeSize = LZW_MIN_CODE_SIZE + 1;
+					maxCode = LZW_CLEAR + 1;
+				}
+				curr = pixel;
+			}
+		}
+	}
+	gif_put_code(gif, curr, codeSize);
+	gif_put_code(gif, LZW_CLEAR + 1, codeSize);	// end of information
+	if (gif->bitCount > 0) {
+		gif_put_code(gif, 0, 8 - gif->bitCount);
+	}
+	if (gif->blockLen > 0) {
+		fputc(gif->blockLen, gif->f);
+		fwrite(gif->block, 1, gif->blockLen, gif->f);
+	}
+	fputc(0, gif->f);	// end of image data
+}
+
+int main(int argc, char **argv) {
+
+	const char *gifPath = NULL;
+	const char *prefix = NULL;
+	int scale = 4;
+	int delay = 10;
+	int animate = 0;
+	long termBytes = 0;
+	int opt;
+	uint8_t *data;
+	int len;
+	int pos;
+	int used;
+	int frames = 0;
+	char cells[CAG_RECORDER_MAX_CELLS];
+	char path[256];
+	char status[CAG_TERM_STATUS_MAX + 1];
+	CagRecorderDecoder dec;
+	static struct gifWriter gif;
+
+	while ((opt = getopt(argc, argv, "ag:p:s:t:")) != -1) {
+		switch (opt) {
+			case 'a':
+				animate = 1;
+				break;
+			case 'g':
+				gifPath = optarg;
+				break;
+			case 'p':
+				prefix = optarg;
+				break;
+			case 's':
+				scale = atoi(optarg);
+				break;
+			case 't':
+				delay = atoi(optarg);
+				break;
+			default:
+				optind = argc;
+				break;
+		}
+	}
+	if (optind != argc - 1 || scale < 1) {
+		fprintf(stderr, "usage: %s [-a] [-g out.gif] [-p frame_prefix] [-s scale] [-t delay_cs] recording\n", argv[0]);
+		return 1;
+	}
+
+	data = read_recording(argv[optind], &len);
+	if (data == NULL || (pos = s4375116_lib_cag_recorder_decode_header(&dec, data, len)) < 0) {
+		fprintf(stderr, "%s: not a recording\n", argv[optind]);
+		return 1;
+	}
+
+	if (gifPath != NULL) {
+		gif.f = fopen(gifPath, "wb");
+		if (gif.f == NULL) {
+			perror(gifPath);
+			return 1;
+		}
+		gif_begin(&gif, dec.width * scale, dec.height * scale);
+	}
+	if (animate) {
+		s4375116_lib_cag_term_init(term_stdout_write);
+	}
+
+	while ((used = s4375116_lib_cag_recorder_decode(&dec, data + pos, len - pos, cells)) > 0) {
+		pos += used;
+		if (!dec.keyed) {	// dump started part way through, wait for a key frame
+			continue;
+		}
+		if (gifPath != NULL) {
+			gif_frame(&gif, cells, dec.width, dec.height, scale, delay);
+		}
+		if (prefix != NULL) {
+			snprintf(path, sizeof(path), "%s%05d.pbm", prefix, frames);
+			write_pbm(path, cells, dec.width, dec.height, scale);
+		}
+		if (animate) {
+			snprintf(status, sizeof(status), "G:%lu", dec.generation);
+			termBytes += s4375116_lib_cag_term_render(cells, dec.width, dec.height, status);
+			usleep(delay * 10000);
+		}
+		frames++;
+	}
+	if (used < 0) {
+		fprintf(stderr, "corrupt record at byte %d, stopping\n", pos);
+	}
+
+	if (gifPath != NULL) {
+		fputc(0x3B, gif.f);
+		fclose(gif.f);
+	}
+
+	if (animate) {
+		s4375116_lib_cag_term_release();
+		printf("terminal: %ld bytes (%.1f bytes/frame)\n", termBytes, frames ? (double) termBytes / frames : 0.0);
+	}
+	printf("%dx%d grid, %d frames, %d bytes (%.1f bytes/frame), last generation %lu\n", dec.width, dec.height,
+			frames, len, frames ? (double) len / frames : 0.0, dec.generation);
+	free(data);
+	return 0;
+}
@@ -0,0 +1,213 @@
+ /**
+ **************************************************************
+ * @file host/density_bench.c
+ * @author Sami Kaab - s4375116
+ * @date 19102026
+ * @brief Benchmark the zoomed out density view of a 512x256 world on the 128x64 panel
+ * Runs a game of life soup and draws it every generation with
+ *  scan:    count every block from the whole world, then dither
+ *  pyramid: s4375116_CAG_density, counts kept up to date while stepping
+ * Both go through s4375116_oled_fb; the panels are compared after every frame.
+ * usage: density_bench [-n frames] [-s seed] [-l level] [-d frame_prefix]
+ ***************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "oled_pixel.h"
+#include "ssd1306_host.h"
+#include "s4375116_oled_fb.h"
+#include "s4375116_CAG_density.h"
+
+#define WORLD_WIDTH		512	// cells
+#define WORLD_HEIGHT	256
+#define PANEL_WIDTH		128	// pixels
+#define PANEL_HEIGHT	64
+
+static char world[WORLD_HEIGHT][WORLD_WIDTH];
+static char next[WORLD_HEIGHT][WORLD_WIDTH];
+static int trackChanges;	// report births and deaths to the pyramid while stepping
+
+/* same matrix as s4375116_CAG_density.c */
+static const unsigned char bayer[4][4] = {
+	{ 0,  8,  2, 10},
+	{12,  4, 14,  6},
+	{ 3, 11,  1,  9},
+	{15,  7, 13,  5},
+};
+
+static void soup(unsigned int seed) {
+
+	srand(seed);
+	for (int y = 0; y < WORLD_HEIGHT; y++) {
+		for (int x = 0; x < WORLD_WIDTH; x++) {
+			world[y][x] = (rand() % 3) == 0;
+		}
+	}
+}
+
+/**
+ * @brief Step the world one generation with the bounded rules of the simulator
+ *
+ */
+static void step(void) {
+
+	int sum;
+
+	for (int y = 0; y < WORLD_HEIGHT; y++) {
+		for (int x = 0; x < WORLD_WIDTH; x++) {
+			sum = 0;
+			for (int j = -1; j < 2; j++) {
+				for (int i = -1; i < 2; i++) {
+					if ((i || j) && y + j >= 0 && y + j < WORLD_HEIGHT && x + i >= 0 && x + i < WORLD_WIDTH) {
+						sum += world[y + j][x + i];
+					}
+				}
+			}
+			next[y][x] = (sum == 3) || (world[y][x] && sum == 2);
+			if (trackChanges && next[y][x] != world[y][x]) {
+				s4375116_lib_cag_density_change(x, y, next[y][x] ? 1 : -1);
+			}
+		}
+	}
+	memcpy(world, next, sizeof(world));
+}
+
+/**
+ * @brief Count every block of the level from the whole world and draw it dithered
+ *
+ */
+static void render_scan(int level) {
+
+	static int counts[PANEL_HEIGHT][PANEL_WIDTH];
+	int size = 1 << level;
+	unsigned char bits;
+
+	memset(counts, 0, sizeof(counts));
+	for (int y = 0; y < WORLD_HEIGHT && (y >> level) < PANEL_HEIGHT; y++) {
+		for (int x = 0; x < WORLD_WIDTH && (x >> level) < PANEL_WIDTH; x++) {
+			counts[y >> level][x >> level] += world[y][x];
+		}
+	}
+
+	for (int page = 0; page < PANEL_HEIGHT / 8; page++) {
+		for (int px = 0; px < PANEL_WIDTH; px++) {
+			bits = 0;
+			for (int b = 0; b < 8; b++) {
+				if (counts[page * 8 + b][px] * 32 > (2 * bayer[(page * 8 + b) & 3][px & 3] + 1) * size * size) {
+					bits |= 1 << b;
+				}
+			}
+			s4375116_lib_oled_fb_put(px, page, bits, 0xFF);
+		}
+	}
+	s4375116_lib_oled_fb_flush();
+}
+
+static void render_pyramid(int level) {
+
+	s4375116_lib_cag_density_render(level, 0, 0, PANEL_WIDTH, PANEL_HEIGHT);
+	s4375116_lib_oled_fb_flush();
+}
+
+static double now_ns(void) {
+
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int main(int argc, char **argv) {
+
+	int frames = 200;
+	unsigned int seed = 1;
+	int level = 2;
+	const char *prefix = NULL;
+	int opt;
+	double start, cpu[2] = {0, 0}, stepCpu[2] = {0, 0};
+	unsigned char panel[PANEL_HEIGHT][PANEL_WIDTH];
+	int mismatches = 0;
+	char path[256];
+	ssd1306HostStats_t stats;
+
+	while ((opt = getopt(argc, argv, "n:s:l:d:")) != -1) {
+		switch (opt) {
+			case 'n':
+				frames = atoi(optarg);
+				break;
+			case 's':
+				seed = (unsigned int) atoi(optarg);
+				break;
+			case 'l':
+				level = atoi(optarg);
+				break;
+			case 'd':
+				prefix = optarg;
+				break;
+			default:
+				fprintf(stderr, "usage: %s [-n frames] [-s seed] [-l level] [-d frame_prefix]\n", argv[0]);
+				return 1;
+		}
+	}
+
+	if (s4375116_lib_cag_density_init(WORLD_WIDTH, WORLD_HEIGHT) < level || level < 1) {
+		fprintf(stderr, "level %d not available (CAG_DENSITY_POOL_SIZE %d)\n", level, CAG_DENSITY_POOL_SIZE);
+		return 1;
+	}
+
+	printf("%dx%d world, level %d (%dx%d blocks)\n", WORLD_WIDTH, WORLD_HEIGHT, level, 1 << level, 1 << level);
+	printf("%-10s %14s %14s %12s\n", "renderer", "render ns/frm", "step ns/frm", "bytes/frm");
+
+	for (int r = 0; r < 2; r++) {
+
+		ssd1306_Init();
+		s4375116_lib_oled_fb_clear();
+		s4375116_lib_oled_fb_flush();
+		ssd1306_host_stats_reset();
+		soup(seed);
+		trackChanges = r;
+		if (r) {
+			s4375116_lib_cag_density_rebuild(&world[0][0]);
+		}
+
+		for (int f = 0; f < frames; f++) {
+			start = now_ns();
+			if (r) {
+				render_pyramid(level);
+			} else {
+				render_scan(level);
+			}
+			cpu[r] += now_ns() - start;
+
+			for (int y = 0; y < PANEL_HEIGHT; y++) {
+				for (int x = 0; x < PANEL_WIDTH; x++) {
+					if (r == 0 && f == frames - 1) {
+						panel[y][x] = ssd1306_host_pixel(x, y);
+					} else if (r == 1 && f == frames - 1) {
+						mismatches += panel[y][x] != ssd1306_host_pixel(x, y);
+					}
+				}
+			}
+			if (prefix != NULL && r) {
+				snprintf(path, sizeof(path), "%s%05d.pbm", prefix, f);
+				ssd1306_host_dump_pbm(path);
+			}
+
+			start = now_ns();
+			step();
+			stepCpu[r] += now_ns() - start;
+		}
+
+		ssd1306_host_stats_get(&stats);
+		printf("%-10s %14.0f %14.0f %12.1f\n", r ? "pyramid" : "scan", cpu[r] / frames, stepCpu[r] / frames,
+				(double) stats.bytes / frames);
+	}
+
+	printf("last frame %s\n", mismatches ? "DIFFERS" : "identical");
+	return mismatches != 0;
+}
@@ -0,0 +1,24 @@
+/**
+ **************************************************************
+ * @file host/fonts.h
+ * @author Sami Kaab - s4375116 
+ * @date 19102026
+ * @brief Host stand-in for the sourcelib ssd1306 font definitions
+ ***************************************************************
+ */
+
+#ifndef FONTS_H
+#define FONTS_H
+
+#include <stdint.h>
+
+// Font layout matches the sourcelib: one uint16_t per glyph row, MSB is the leftmost pixel
+typedef struct {
+	const uint8_t FontWidth;	// Font width in pixels
+	uint8_t FontHeight;			// Font height in pixels
+	const uint16_t *data;		// Glyph rows for characters 0x20 to 0x7E
+} FontDef;
+
+extern FontDef Font_7x10;
+
+#endif
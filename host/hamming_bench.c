@@ -0,0 +1,241 @@
+ /**
+ **************************************************************
+ * @file host/hamming_bench.c
+ * @author Sami Kaab - s4375116
+ * @date 19102026
+ * @brief Check and time the Hamming buffer functions against the byte functions
+ * Random data is encoded both ways and compared, then every coded byte gets no error,
+ * one flipped bit or two flipped bits and is decoded both ways. The decoded data, the
+ * corrected bytes and the error counts are checked.
+ * The block codes get the same errors per block, and the (72,64) buffer functions are
+ * timed per data byte next to the (8,4) ones.
+ * usage: hamming_bench [-n bytes] [-r rounds] [-s seed]
+ ***************************************************************
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "s4375116_hamming.h"
+
+static volatile unsigned char sink;	// keeps the byte loops from being optimised away
+
+static double now_ns(void) {
+
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * @brief Flip 0, 1 or 2 different bits of every coded byte
+ *
+ * @param flips returns the number flipped in each byte
+ */
+static void add_errors(uint8_t *coded, uint8_t *flips, int len) {
+
+	int a, b;
+
+	for (int i = 0; i < len; i++) {
+		flips[i] = rand() % 3;
+		a = rand() % 8;
+		b = (a + 1 + rand() % 7) % 8;
+		if (flips[i] > 0) {
+			coded[i] ^= 1 << a;
+		}
+		if (flips[i] > 1) {
+			coded[i] ^= 1 << b;
+		}
+	}
+}
+
+/**
+ * @brief Flip 0, 1 or 2 different bits of random blocks of a block code, check the status and data
+ *
+ * @return int number of blocks decoded wrong
+ */
+static int check_block_code(int code, int dataBits, int blocks) {
+
+	int checkBits = (code == HAMMING_16_11) ? 5 : ((code == HAMMING_32_26) ? 6 : 8);
+	int size = dataBits + checkBits;
+	int mismatches = 0;
+	int flips, a, b, bit;
+	uint64_t mask = ~(uint64_t) 0 >> (64 - dataBits);
+	uint64_t data, received;
+	unsigned char check;
+	unsigned long counts[3] = {0, 0, 0};
+	HammingStatus status;
+
+	for (int i = 0; i < blocks; i++) {
+		data = (((uint64_t) rand() << 42) ^ ((uint64_t) rand() << 21) ^ rand()) & mask;
+		received = data;
+		check = s4375116_lib_hamming_block_encode(code, data);
+		flips = rand() % 3;
+		a = rand() % size;
+		b = (a + 1 + rand() % (size - 1)) % size;
+		for (int n = 0; n < flips; n++) {
+			bit = n ? b : a;
+			if (bit < dataBits) {
+				received ^= (uint64_t) 1 << bit;
+			} else {
+				check ^= 1 << (bit - dataBits);
+			}
+		}
+
+		status = s4375116_lib_hamming_block_decode(code, &received, check, &bit);
+		counts[status]++;
+		mismatches += (int) status != flips;
+		mismatches += (flips < 2) && received != data;
+		mismatches += (flips == 1) ? bit != a : bit != -1;
+	}
+	printf("(%d,%d) blocks clean %lu, corrected %lu, uncorrectable %lu\n", size, dataBits,
+			counts[HAMMING_CLEAN], counts[HAMMING_CORRECTED], counts[HAMMING_DOUBLE]);
+	return mismatches;
+}
+
+int main(int argc, char **argv) {
+
+	int len = 4096;
+	int rounds = 1000;
+	unsigned int seed = 1;
+	int opt;
+	int mismatches = 0;
+	unsigned long expected[3] = {0, 0, 0};
+	uint8_t *data, *coded, *ref, *decoded, *flips;
+	unsigned short word;
+	int blockLen;
+	double start, cpu[6];
+	HammingCounts counts;
+
+	while ((opt = getopt(argc, argv, "n:r:s:")) != -1) {
+		switch (opt) {
+			case 'n':
+				len = atoi(optarg);
+				break;
+			case 'r':
+				rounds = atoi(optarg);
+				break;
+			case 's':
+				seed = (unsigned int) atoi(optarg);
+				break;
+			default:
+				fprintf(stderr, "usage: %s [-n bytes] [-r rounds] [-s seed]\n", argv[0]);
+				return 1;
+		}
+	}
+	if (len < 1 || rounds < 1) {
+		fprintf(stderr, "usage: %s [-n bytes] [-r rounds] [-s seed]\n", argv[0]);
+		return 1;
+	}
+
+	data = malloc(len);
+	coded = malloc(2 * len + 16);	// room for the (72,64) blocks as well
+	ref = malloc(2 * len + 16);
+	decoded = malloc(len + 8);
+	flips = malloc(2 * len);
+
+	srand(seed);
+	for (int i = 0; i < len; i++) {
+		data[i] = rand();
+	}
+
+	// encode
+	s4375116_lib_hamming_encode_buffer(data, coded, len);
+	for (int i = 0; i < len; i++) {
+		word = s4375116_lib_hamming_byte_encode(data[i]);
+		ref[2 * i] = word & 0xFF;
+		ref[2 * i + 1] = word >> 8;
+	}
+	mismatches += memcmp(coded, ref, 2 * len) != 0;
+
+	// decode with errors
+	add_errors(coded, flips, 2 * len);
+	for (int i = 0; i < 2 * len; i++) {
+		expected[flips[i]]++;
+	}
+	s4375116_lib_hamming_decode_buffer(coded, decoded, 2 * len, &counts);
+	for (int i = 0; i < len; i++) {
+		mismatches += decoded[i] != (s4375116_lib_hamming_byte_decode(coded[2 * i]) |
+				(s4375116_lib_hamming_byte_decode(coded[2 * i + 1]) << 4));
+		for (int n = 0; n < 2; n++) {
+			if (flips[2 * i + n] < 2) {	// one error is always corrected
+				mismatches += ((decoded[i] >> (4 * n)) & 0x0F) != ((data[i] >> (4 * n)) & 0x0F);
+			}
+		}
+	}
+	mismatches += counts.corrected != expected[1] || counts.uncorrectable != expected[2];
+
+	printf("%d bytes, %d byte lanes per word\n", len, (int) sizeof(uintptr_t));
+	printf("blocks with 1 error %lu (corrected %lu), with 2 errors %lu (uncorrectable %lu)\n",
+			expected[1], counts.corrected, expected[2], counts.uncorrectable);
+
+	// block codes, then the (72,64) buffers against the byte functions
+	mismatches += check_block_code(HAMMING_16_11, 11, 100000);
+	mismatches += check_block_code(HAMMING_32_26, 26, 100000);
+	mismatches += check_block_code(HAMMING_72_64, 64, 100000);
+
+	blockLen = s4375116_lib_hamming_72_encode_buffer(data, coded, len);
+	for (int i = 0; i < blockLen; i += 9) {	// one error in every other block
+		if ((i / 9) % 2) {
+			coded[i + rand() % 9] ^= 1 << (rand() % 8);
+		}
+	}
+	memset(decoded, 0, len);
+	mismatches += s4375116_lib_hamming_72_decode_buffer(coded, decoded, blockLen, &counts) != (len + 7) / 8 * 8;
+	mismatches += memcmp(decoded, data, len) != 0;
+	mismatches += counts.corrected != (unsigned long) (blockLen / 9 / 2) || counts.uncorrectable != 0;
+	mismatches += s4375116_lib_hamming_72_decode_buffer(coded, decoded, blockLen - 1, NULL) != -1;
+	printf("(72,64) buffer %d coded bytes for %d (8,4 uses %d), corrected %lu blocks\n", blockLen, len, 2 * len,
+			counts.corrected);
+
+	// timing
+	start = now_ns();
+	for (int r = 0; r < rounds; r++) {
+		for (int i = 0; i < len; i++) {
+			word = s4375116_lib_hamming_byte_encode(data[i]);
+			ref[2 * i] = word & 0xFF;
+			ref[2 * i + 1] = word >> 8;
+		}
+	}
+	cpu[0] = now_ns() - start;
+	start = now_ns();
+	for (int r = 0; r < rounds; r++) {
+		s4375116_lib_hamming_encode_buffer(data, ref, len);
+	}
+	cpu[1] = now_ns() - start;
+	start = now_ns();
+	for (int r = 0; r < rounds; r++) {
+		for (int i = 0; i < len; i++) {
+			decoded[i] = s4375116_lib_hamming_byte_decode(coded[2 * i]) | (s4375116_lib_hamming_byte_decode(coded[2 * i + 1]) << 4);
+			sink = s4375116_lib_hamming_parity_error(coded[2 * i]) + s4375116_lib_hamming_parity_error(coded[2 * i + 1]);
+		}
+	}
+	cpu[2] = now_ns() - start;
+	start = now_ns();
+	for (int r = 0; r < rounds; r++) {
+		s4375116_lib_hamming_decode_buffer(coded, decoded, 2 * len, &counts);
+	}
+	cpu[3] = now_ns() - start;
+	start = now_ns();
+	for (int r = 0; r < rounds; r++) {
+		s4375116_lib_hamming_72_encode_buffer(data, coded, len);
+	}
+	cpu[4] = now_ns() - start;
+	start = now_ns();
+	for (int r = 0; r < rounds; r++) {
+		s4375116_lib_hamming_72_decode_buffer(coded, decoded, blockLen, &counts);
+	}
+	cpu[5] = now_ns() - start;
+
+	printf("%-8s %14s %14s %14s\n", "", "byte ns/byte", "buffer ns/byte", "72,64 ns/byte");
+	printf("%-8s %14.2f %14.2f %14.2f\n", "encode", cpu[0] / rounds / len, cpu[1] / rounds / len, cpu[4] / rounds / len);
+	printf("%-8s %14.2f %14.2f %14.2f\n", "decode", cpu[2] / rounds / len, cpu[3] / rounds / len, cpu[5] / rounds / len);
+
+	printf("results %s\n", mismatches ? "DIFFER" : "identical");
+	return mismatches != 0;
+}
@@ -0,0 +1,251 @@
+/**
+ **************************************************************
+ * @file host/oled_bench.c
+ * @author Sami Kaab - s4375116 
+ * @date 19102026
+ * @brief Benchmark the OLED renderers against the SSD1306 emulator
+ * Runs a game of life soup (or the s4 timer text) through each renderer and reports the host CPU time
+ * and the I2C traffic every frame would cost on the board.
+ * -r records the soup with s4375116_CAG_recorder for host/cag_replay.
+ * usage: oled_bench [-n frames] [-s seed] [-d frame_prefix] [-r recording]
+ ***************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "oled_pixel.h"
+#include "oled_string.h"
+#include "ssd1306_host.h"
+#include "s4375116_oled_fb.h"
+#include "s4375116_CAG_render.h"
+#include "s4375116_CAG_recorder.h"
+
+#define GRID_HEIGHT	16	// cells, as in s4375116_CAG_display.h
+#define GRID_WIDTH	64	// cells
+#define CELL_SIZE	2	// pixels
+
+static char grid[GRID_HEIGHT][GRID_WIDTH];
+static unsigned long generation;
+
+/**
+ * @brief Fill the grid with a random soup
+ * 
+ * @param seed random seed
+ */
+static void soup(unsigned int seed) {
+
+	srand(seed);
+	for (int y = 0; y < GRID_HEIGHT; y++) {
+		for (int x = 0; x < GRID_WIDTH; x++) {
+			grid[y][x] = (rand() % 3) == 0;
+		}
+	}
+}
+
+/**
+ * @brief Step the grid one generation with the same bounded rules as the simulator
+ * 
+ */
+static void step(void) {
+
+	static char next[GRID_HEIGHT][GRID_WIDTH];
+	int sum;
+
+	for (int y = 0; y < GRID_HEIGHT; y++) {
+		for (int x = 0; x < GRID_WIDTH; x++) {
+			sum = 0;
+			for (int j = -1; j < 2; j++) {
+				for (int i = -1; i < 2; i++) {
+					if ((i || j) && y + j >= 0 && y + j < GRID_HEIGHT && x + i >= 0 && x + i < GRID_WIDTH) {
+						sum += grid[y + j][x + i];
+					}
+				}
+			}
+			next[y][x] = (sum == 3) || (grid[y][x] && sum == 2);
+		}
+	}
+	memcpy(grid, next, sizeof(grid));
+	generation++;
+}
+
+/**
+ * @brief Original display_to_oled(): clear, draw every cell pixel by pixel and send the whole frame buffer
+ * 
+ */
+static void render_full(void) {
+
+	ssd1306_Fill(Black);
+	for (int y = 0; y < GRID_HEIGHT; y++) {
+		for (int x = 0; x < GRID_WIDTH; x++) {
+			for (int j = 0; j < CELL_SIZE; j++) {
+				for (int i = 0; i < CELL_SIZE; i++) {
+					ssd1306_DrawPixel(x * CELL_SIZE + i, y * CELL_SIZE + j, grid[y][x]);
+				}
+			}
+		}
+	}
+	ssd1306_UpdateScreen();
+}
+
+/**
+ * @brief Draw the grid into the s4375116_oled_fb frame buffer and send only the changed columns
+ * 
+ */
+static void render_fb(void) {
+
+	s4375116_lib_cag_render_grid(&grid[0][0], GRID_WIDTH, GRID_HEIGHT, CELL_SIZE);
+	s4375116_lib_oled_fb_flush();
+}
+
+/**
+ * @brief As render_fb() plus the status strip drawn by the CAG display
+ * 
+ */
+static void render_fb_status(void) {
+
+	static OledFbText counts = {1, GRID_HEIGHT * CELL_SIZE + 6, ""};
+	char text[OLED_FB_TEXT_MAX + 1];
+	int population = 0;
+
+	for (int y = 0; y < GRID_HEIGHT; y++) {
+		for (int x = 0; x < GRID_WIDTH; x++) {
+			population += grid[y][x];
+		}
+	}
+
+	s4375116_lib_cag_render_grid(&grid[0][0], GRID_WIDTH, GRID_HEIGHT, CELL_SIZE);
+	snprintf(text, sizeof(text), "G:%lu P:%d", generation, population);
+	s4375116_lib_oled_fb_text_update(&counts, text);
+	s4375116_lib_oled_fb_flush();
+}
+
+/**
+ * @brief Original write_to_oled() with the s4 dual timer text: clear, draw the string and send the whole frame buffer
+ * 
+ */
+static void render_text_full(void) {
+
+	char text[20];
+
+	snprintf(text, sizeof(text), "%lu:%lu", (generation / 100) % 1000, generation % 100);
+	ssd1306_Fill(Black);
+	ssd1306_SetCursor(10, 10);
+	ssd1306_WriteString(text, Font_7x10, SSD1306_WHITE);
+	ssd1306_UpdateScreen();
+}
+
+/**
+ * @brief Current write_to_oled() with the s4 dual timer text: redraw and send only the characters that changed
+ * 
+ */
+static void render_text_fb(void) {
+
+	static OledFbText shown = {10, 10, ""};
+	char text[20];
+
+	snprintf(text, sizeof(text), "%lu:%lu", (generation / 100) % 1000, generation % 100);
+	s4375116_lib_oled_fb_text_update(&shown, text);
+	s4375116_lib_oled_fb_flush();
+}
+
+struct renderer {
+	const char *name;
+	void (*render)(void);
+};
+
+static const struct renderer renderers[] = {
+	{"full", render_full},
+	{"fb", render_fb},
+	{"fb+status", render_fb_status},
+	{"text-full", render_text_full},
+	{"text-fb", render_text_fb},
+};
+
+static double now_ns(void) {
+
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int main(int argc, char **argv) {
+
+	int frames = 1000;
+	unsigned int seed = 1;
+	const char *prefix = NULL;
+	const char *recording = NULL;
+	int opt;
+	double start, cpu;
+	ssd1306HostStats_t stats;
+	char path[256];
+
+	while ((opt = getopt(argc, argv, "n:s:d:r:")) != -1) {
+		switch (opt) {
+			case 'n':
+				frames = atoi(optarg);
+				break;
+			case 's':
+				seed = (unsigned int) atoi(optarg);
+				break;
+			case 'd':
+				prefix = optarg;
+				break;
+			case 'r':
+				recording = optarg;
+				break;
+			default:
+				fprintf(stderr, "usage: %s [-n frames] [-s seed] [-d frame_prefix] [-r recording]\n", argv[0]);
+				return 1;
+		}
+	}
+
+	if (recording != NULL) {
+		if (s4375116_lib_cag_recorder_open(recording, GRID_WIDTH, GRID_HEIGHT) < 0) {
+			perror(recording);
+			return 1;
+		}
+		soup(seed);
+		generation = 0;
+		for (int f = 0; f < frames; f++) {
+			s4375116_lib_cag_recorder_frame(&grid[0][0], generation);
+			step();
+		}
+		s4375116_lib_cag_recorder_close();
+	}
+
+	printf("%-10s %12s %12s %12s %12s\n", "renderer", "cpu ns/frm", "xfers/frm", "bytes/frm", "bus ms/frm");
+
+	for (size_t r = 0; r < sizeof(renderers) / sizeof(renderers[0]); r++) {
+
+		ssd1306_Init();
+		s4375116_lib_oled_fb_clear();	// panel is blank after init, keep the frame buffer in step
+		s4375116_lib_oled_fb_flush();
+		soup(seed);
+		generation = 0;
+		ssd1306_host_stats_reset();
+
+		cpu = 0;
+		for (int f = 0; f < frames; f++) {
+			start = now_ns();
+			renderers[r].render();
+			cpu += now_ns() - start;
+			if (prefix != NULL) {	// what the panel shows after each frame
+				snprintf(path, sizeof(path), "%s%s-%05d.pbm", prefix, renderers[r].name, f);
+				ssd1306_host_dump_pbm(path);
+			}
+			step();
+		}
+
+		ssd1306_host_stats_get(&stats);
+		printf("%-10s %12.0f %12.1f %12.1f %12.2f\n", renderers[r].name, cpu / frames,
+				(double) stats.transactions / frames, (double) stats.bytes / frames,
+				ssd1306_host_bus_us(&stats) / frames / 1000.0);
+	}
+
+	return 0;
+}
@@ -0,0 +1,45 @@
+/**
+ **************************************************************
+ * @file host/oled_pixel.h
+ * @author Sami Kaab - s4375116 
+ * @date 19102026
+ * @brief Host stand-in for the sourcelib ssd1306 pixel functions
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * ssd1306_Init() - Send the init sequence and clear the panel
+ * ssd1306_Fill() - Fill the frame buffer with one colour
+ * ssd1306_UpdateScreen() - Send the whole frame buffer to the panel
+ * ssd1306_DrawPixel() - Set one pixel in the frame buffer
+ * ssd1306_SetCursor() - Set the position of the next character
+ * ssd1306_WriteCommand() - Send one command byte to the panel
+ * ssd1306_WriteData() - Send display data bytes to the panel
+ ***************************************************************
+ */
+
+#ifndef OLED_PIXEL_H
+#define OLED_PIXEL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define SSD1306_WIDTH	128	// pixels
+#define SSD1306_HEIGHT	64	// pixels
+
+typedef enum {
+	Black = 0x00,	// pixel off
+	White = 0x01	// pixel on
+} SSD1306_COLOR;
+
+#define SSD1306_BLACK	Black
+#define SSD1306_WHITE	White
+
+void ssd1306_Init(void);
+void ssd1306_Fill(SSD1306_COLOR color);
+void ssd1306_UpdateScreen(void);
+void ssd1306_DrawPixel(uint8_t x, uint8_t y, SSD1306_COLOR color);
+void ssd1306_SetCursor(uint8_t x, uint8_t y);
+void ssd1306_WriteCommand(uint8_t byte);
+void ssd1306_WriteData(uint8_t *buffer, size_t buff_size);
+
+#endif
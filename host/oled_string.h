@@ -0,0 +1,24 @@
+/**
+ **************************************************************
+ * @file host/oled_string.h
+ * @author Sami Kaab - s4375116 
+ * @date 19102026
+ * @brief Host stand-in for the sourcelib ssd1306 string functions
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * ssd1306_WriteChar() - Draw one character at the cursor
+ * ssd1306_WriteString() - Draw a string at the cursor
+ ***************************************************************
+ */
+
+#ifndef OLED_STRING_H
+#define OLED_STRING_H
+
+#include "oled_pixel.h"
+#include "fonts.h"
+
+char ssd1306_WriteChar(char ch, FontDef Font, SSD1306_COLOR color);
+char ssd1306_WriteString(char *str, FontDef Font, SSD1306_COLOR color);
+
+#endif
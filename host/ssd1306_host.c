@@ -0,0 +1,370 @@
+/**
+ **************************************************************
+ * @file host/ssd1306_host.c
+ * @author Sami Kaab - s4375116 
+ * @date 19102026
+ * @brief SSD1306 emulator used to run the OLED renderers on the host
+ * Implements the ssd1306_* functions the mylib display code calls. Drawing goes
+ * into a RAM frame buffer like the sourcelib driver, and everything sent to the
+ * panel is decoded into an emulated panel memory and counted as bus traffic.
+ * REFERENCE: SSD1306 datasheet (command table, page addressing mode)
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * ssd1306_host_stats_get() - Get the bus traffic counted since the last reset
+ * ssd1306_host_stats_reset() - Reset the bus traffic counters
+ * ssd1306_host_bus_us() - Estimated time the counted traffic takes on the I2C bus
+ * ssd1306_host_pixel() - Read a pixel from the emulated panel memory
+ * ssd1306_host_dump_pbm() - Write the emulated panel to a PBM image
+ * ssd1306_host_dump_frames() - Dump the panel to a numbered PBM after every update
+ ***************************************************************
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "oled_pixel.h"
+#include "oled_string.h"
+#include "ssd1306_host.h"
+
+#define SSD1306_PAGES	(SSD1306_HEIGHT / 8)
+
+#define I2C_ADDRESS_BYTES	2	// slave address + control byte in front of every transfer
+#define I2C_BITS_PER_BYTE	9	// 8 data bits + ack
+
+static uint8_t SSD1306_Buffer[SSD1306_WIDTH * SSD1306_PAGES];	// driver frame buffer
+static uint8_t panelRam[SSD1306_WIDTH * SSD1306_PAGES];		// emulated panel memory (GDDRAM)
+
+static ssd1306HostStats_t stats;
+
+static uint8_t currentX;	// text cursor
+static uint8_t currentY;
+
+/* panel addressing state */
+static uint8_t addressingMode = 0x02;	// page addressing mode after reset
+static uint8_t page;
+static uint8_t column;
+static uint8_t columnStart, columnEnd = SSD1306_WIDTH - 1;
+static uint8_t pageStart, pageEnd = SSD1306_PAGES - 1;
+
+/* multi byte command being received */
+static uint8_t pendingCommand;
+static int pendingArgs;
+static int argIndex;
+
+static const char *framePrefix;
+static unsigned long frameNumber;
+
+/**
+ * @brief Number of argument bytes that follow a command byte
+ * 
+ * @param cmd the command byte
+ * @return int number of argument bytes
+ */
+static int command_args(uint8_t cmd) {
+
+	switch (cmd) {
+		case 0x21:	// column address
+		case 0x22:	// page address
+			return 2;
+		case 0x20:	// memory addressing mode
+		case 0x81:	// contrast
+		case 0x8D:	// charge pump
+		case 0xA8:	// multiplex ratio
+		case 0xD3:	// display offset
+		case 0xD5:	// clock divide
+		case 0xD9:	// pre-charge period
+		case 0xDA:	// com pins
+		case 0xDB:	// vcomh deselect level
+			return 1;
+		default:
+			return 0;
+	}
+}
+
+/**
+ * @brief Apply the argument of a multi byte command to the addressing state
+ * 
+ * @param arg the argument byte
+ */
+static void command_arg(uint8_t arg) {
+
+	if (pendingCommand == 0x20) {
+		addressingMode = arg & 0x03;
+	} else if (pendingCommand == 0x21) {
+		if (argIndex == 0) {
+			columnStart = arg & 0x7F;
+			column = columnStart;
+		} else {
+			columnEnd = arg & 0x7F;
+		}
+	} else if (pendingCommand == 0x22) {
+		if (argIndex == 0) {
+			pageStart = arg & 0x07;
+			page = pageStart;
+		} else {
+			pageEnd = arg & 0x07;
+		}
+	}
+}
+
+/*
+ * Send one command byte to the panel
+ */
+void ssd1306_WriteCommand(uint8_t byte) {
+
+	stats.transactions++;
+	stats.bytes += I2C_ADDRESS_BYTES + 1;
+
+	if (pendingArgs > 0) {
+		command_arg(byte);
+		argIndex++;
+		pendingArgs--;
+		return;
+	}
+
+	if (byte >= 0xB0 && byte <= 0xB7) {	// page start (page addressing mode)
+		page = byte & 0x07;
+	} else if (byte <= 0x0F) {				// lower column start nibble
+		column = (column & 0xF0) | byte;
+	} else if (byte >= 0x10 && byte <= 0x1F) {	// upper column start nibble
+		column = (column & 0x0F) | ((byte & 0x07) << 4);
+	} else {
+		pendingCommand = byte;
+		pendingArgs = command_args(byte);
+		argIndex = 0;
+	}
+}
+
+/*
+ * Send display data bytes to the panel
+ */
+void ssd1306_WriteData(uint8_t *buffer, size_t buff_size) {
+
+	stats.transactions++;
+	stats.bytes += I2C_ADDRESS_BYTES + buff_size;
+	stats.dataBytes += buff_size;
+
+	for (size_t i = 0; i < buff_size; i++) {
+
+		panelRam[page * SSD1306_WIDTH + (column & 0x7F)] = buffer[i];
+
+		if (addressingMode == 0x02) {	// page mode: column wraps within the page
+			column = (column + 1) & 0x7F;
+		} else if (column < columnEnd) {
+			column++;
+		} else {						// horizontal mode: wrap to the next page of the window
+			column = columnStart;
+			page = (page < pageEnd) ? page + 1 : pageStart;
+		}
+	}
+}
+
+/*
+ * Send the init sequence and clear the panel
+ */
+void ssd1306_Init(void) {
+
+	static const uint8_t initSequence[] = {
+		0xAE,			// display off
+		0x20, 0x02,		// page addressing mode
+		0xB0,			// page start
+		0xC8,			// COM scan direction
+		0x00, 0x10,		// column start
+		0x40,			// start line
+		0x81, 0xFF,		// contrast
+		0xA1,			// segment remap
+		0xA6,			// normal display
+		0xA8, 0x3F,		// multiplex ratio
+		0xA4,			// output follows RAM
+		0xD3, 0x00,		// display offset
+		0xD5, 0xF0,		// clock divide
+		0xD9, 0x22,		// pre-charge period
+		0xDA, 0x12,		// com pins
+		0xDB, 0x20,		// vcomh
+		0x8D, 0x14,		// charge pump on
+		0xAF			// display on
+	};
+
+	for (size_t i = 0; i < sizeof(initSequence); i++) {
+		ssd1306_WriteCommand(initSequence[i]);
+	}
+
+	ssd1306_Fill(Black);
+	ssd1306_UpdateScreen();
+
+	currentX = 0;
+	currentY = 0;
+}
+
+/*
+ * Fill the frame buffer with one colour
+ */
+void ssd1306_Fill(SSD1306_COLOR color) {
+
+	memset(SSD1306_Buffer, (color == Black) ? 0x00 : 0xFF, sizeof(SSD1306_Buffer));
+}
+
+/*
+ * Send the whole frame buffer to the panel, one page at a time
+ */
+void ssd1306_UpdateScreen(void) {
+
+	char path[256];
+
+	for (uint8_t i = 0; i < SSD1306_PAGES; i++) {
+		ssd1306_WriteCommand(0xB0 + i);
+		ssd1306_WriteCommand(0x00);
+		ssd1306_WriteCommand(0x10);
+		ssd1306_WriteData(&SSD1306_Buffer[SSD1306_WIDTH * i], SSD1306_WIDTH);
+	}
+	stats.updates++;
+
+	if (framePrefix != NULL) {
+		snprintf(path, sizeof(path), "%s%05lu.pbm", framePrefix, frameNumber++);
+		ssd1306_host_dump_pbm(path);
+	}
+}
+
+/*
+ * Set one pixel in the frame buffer
+ */
+void ssd1306_DrawPixel(uint8_t x, uint8_t y, SSD1306_COLOR color) {
+
+	if (x >= SSD1306_WIDTH || y >= SSD1306_HEIGHT) {
+		return;
+	}
+
+	if (color == White) {
+		SSD1306_Buffer[x + (y / 8) * SSD1306_WIDTH] |= 1 << (y % 8);
+	} else {
+		SSD1306_Buffer[x + (y / 8) * SSD1306_WIDTH] &= ~(1 << (y % 8));
+	}
+}
+
+/*
+ * Set the position of the next character
+ */
+void ssd1306_SetCursor(uint8_t x, uint8_t y) {
+
+	currentX = x;
+	currentY = y;
+}
+
+/*
+ * Draw one character at the cursor, background pixels are drawn in the inverse colour
+ */
+char ssd1306_WriteChar(char ch, FontDef Font, SSD1306_COLOR color) {
+
+	uint16_t b;
+
+	if (ch < 32 || ch > 126) {
+		return 0;
+	}
+
+	if (SSD1306_WIDTH < (currentX + Font.FontWidth) || SSD1306_HEIGHT < (currentY + Font.FontHeight)) {
+		return 0;	// not enough space on the current line
+	}
+
+	for (int i = 0; i < Font.FontHeight; i++) {
+		b = Font.data[(ch - 32) * Font.FontHeight + i];
+		for (int j = 0; j < Font.FontWidth; j++) {
+			if ((b << j) & 0x8000) {
+				ssd1306_DrawPixel(currentX + j, currentY + i, color);
+			} else {
+				ssd1306_DrawPixel(currentX + j, currentY + i, !color);
+			}
+		}
+	}
+
+	currentX += Font.FontWidth;
+
+	return ch;
+}
+
+/*
+ * Draw a string at the cursor, returns the character that did not fit or 0
+ */
+char ssd1306_WriteString(char *str, FontDef Font, SSD1306_COLOR color) {
+
+	while (*str) {
+		if (ssd1306_WriteChar(*str, Font, color) != *str) {
+			return *str;
+		}
+		str++;
+	}
+
+	return *str;
+}
+
+/*
+ * Get the bus traffic counted since the last reset
+ */
+void ssd1306_host_stats_get(ssd1306HostStats_t *out) {
+
+	*out = stats;
+}
+
+/*
+ * Reset the bus traffic counters
+ */
+void ssd1306_host_stats_reset(void) {
+
+	memset(&stats, 0, sizeof(stats));
+}
+
+/*
+ * Estimated time (us) the counted traffic takes on the I2C bus, including start/stop
+ */
+double ssd1306_host_bus_us(const ssd1306HostStats_t *s) {
+
+	double bits = (double) s->bytes * I2C_BITS_PER_BYTE + (double) s->transactions * 2;
+
+	return bits * 1e6 / SSD1306_HOST_I2C_CLOCKSPEED;
+}
+
+/*
+ * Read a pixel from the emulated panel memory (what the panel shows)
+ */
+int ssd1306_host_pixel(int x, int y) {
+
+	if (x < 0 || x >= SSD1306_WIDTH || y < 0 || y >= SSD1306_HEIGHT) {
+		return 0;
+	}
+	return (panelRam[x + (y / 8) * SSD1306_WIDTH] >> (y % 8)) & 0x01;
+}
+
+/*
+ * Write the emulated panel to a binary PBM image, returns 0 on success
+ */
+int ssd1306_host_dump_pbm(const char *path) {
+
+	FILE *f = fopen(path, "wb");
+	uint8_t row;
+
+	if (f == NULL) {
+		return -1;
+	}
+
+	fprintf(f, "P4\n%d %d\n", SSD1306_WIDTH, SSD1306_HEIGHT);
+	for (int y = 0; y < SSD1306_HEIGHT; y++) {
+		for (int x = 0; x < SSD1306_WIDTH; x += 8) {
+			row = 0;
+			for (int i = 0; i < 8; i++) {
+				row |= ssd1306_host_pixel(x + i, y) << (7 - i);
+			}
+			fputc(row, f);
+		}
+	}
+
+	return fclose(f);
+}
+
+/*
+ * Dump the panel to <prefix>NNNNN.pbm after every ssd1306_UpdateScreen(), NULL to stop
+ */
+void ssd1306_host_dump_frames(const char *prefix) {
+
+	framePrefix = prefix;
+	frameNumber = 0;
+}
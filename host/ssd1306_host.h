@@ -0,0 +1,42 @@
+/**
+ **************************************************************
+ * @file host/ssd1306_host.h
+ * @author Sami Kaab - s4375116 
+ * @date 19102026
+ * @brief SSD1306 emulator used to run the OLED renderers on the host
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * ssd1306_host_stats_get() - Get the bus traffic counted since the last reset
+ * ssd1306_host_stats_reset() - Reset the bus traffic counters
+ * ssd1306_host_bus_us() - Estimated time the counted traffic takes on the I2C bus
+ * ssd1306_host_pixel() - Read a pixel from the emulated panel memory
+ * ssd1306_host_dump_pbm() - Write the emulated panel to a PBM image
+ * ssd1306_host_dump_frames() - Dump the panel to a numbered PBM after every update
+ ***************************************************************
+ */
+
+#ifndef SSD1306_HOST_H
+#define SSD1306_HOST_H
+
+#include <stdint.h>
+
+#define SSD1306_HOST_I2C_CLOCKSPEED	100000	// same bus speed as I2C_DEV_CLOCKSPEED in s4375116_oled.h
+
+// bus traffic that would have been sent to the panel
+struct ssd1306HostStats {
+	unsigned long transactions;	// I2C transfers (one per command byte or data block)
+	unsigned long bytes;		// bytes on the wire, including address and control bytes
+	unsigned long dataBytes;	// display data bytes written to the panel memory
+	unsigned long updates;		// ssd1306_UpdateScreen() calls
+};
+typedef struct ssd1306HostStats ssd1306HostStats_t;
+
+void ssd1306_host_stats_get(ssd1306HostStats_t *stats);
+void ssd1306_host_stats_reset(void);
+double ssd1306_host_bus_us(const ssd1306HostStats_t *stats);
+int ssd1306_host_pixel(int x, int y);
+int ssd1306_host_dump_pbm(const char *path);
+void ssd1306_host_dump_frames(const char *prefix);
+
+#endif
@@ -0,0 +1,237 @@
+ /**
+ **************************************************************
+ * @file host/trace_decode.c
+ * @author Sami Kaab - s4375116
+ * @date 19102026
+ * @brief Format the binary trace log of the board ('trace bin') on the host
+ * Reads a captured terminal log, keeps the "#F" (clock), "#N" (task name) and
+ * "#T" (record) lines of s4375116_trace.c and prints each record with the format
+ * string found at its address in the firmware ELF. Any other line is ignored.
+ * Times are relative to the first record, in ms.
+ * usage: trace_decode [-f cpu_hz] firmware.elf capture.log
+ ***************************************************************
+ */
+
+#include <elf.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define TRACE_RINGS		8		// same as s4375116_trace.h
+#define TRACE_MAX_ARGS	4
+
+static uint8_t *elf;
+static long elfSize;
+
+/**
+ * @brief Read the whole firmware ELF and check it is a 32 bit little endian file
+ *
+ */
+static int load_elf(const char *path) {
+
+	FILE *f = fopen(path, "rb");
+	Elf32_Ehdr *header;
+
+	if (f == NULL) {
+		return -1;
+	}
+	fseek(f, 0, SEEK_END);
+	elfSize = ftell(f);
+	rewind(f);
+	elf = malloc(elfSize);
+	if (fread(elf, 1, elfSize, f) != (size_t) elfSize) {
+		fclose(f);
+		return -1;
+	}
+	fclose(f);
+
+	header = (Elf32_Ehdr *) elf;
+	if (elfSize < (long) sizeof(*header) || memcmp(header->e_ident, ELFMAG, SELFMAG) != 0 ||
+			header->e_ident[EI_CLASS] != ELFCLASS32 || header->e_ident[EI_DATA] != ELFDATA2LSB ||
+			header->e_shoff + (long) header->e_shnum * sizeof(Elf32_Shdr) > (unsigned long) elfSize) {
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * @brief Find the string stored at an address of the firmware
+ *
+ * @return const char* the string, NULL if no loaded section holds the address
+ */
+static const char *elf_string(uint32_t addr) {
+
+	Elf32_Ehdr *header = (Elf32_Ehdr *) elf;
+	Elf32_Shdr *sections = (Elf32_Shdr *) (elf + header->e_shoff);
+
+	for (int i = 0; i < header->e_shnum; i++) {
+		if ((sections[i].sh_flags & SHF_ALLOC) && sections[i].sh_type == SHT_PROGBITS &&
+				addr >= sections[i].sh_addr && addr < sections[i].sh_addr + sections[i].sh_size &&
+				sections[i].sh_offset + sections[i].sh_size <= (unsigned long) elfSize) {
+			// strings are never split across sections, stop at the end of it anyway
+			if (memchr(elf + sections[i].sh_offset + (addr - sections[i].sh_addr), '\0',
+					sections[i].sh_addr + sections[i].sh_size - addr) == NULL) {
+				return NULL;
+			}
+			return (const char *) elf + sections[i].sh_offset + (addr - sections[i].sh_addr);
+		}
+	}
+	return NULL;
+}
+
+/**
+ * @brief Format a record as printf would on the board, 32 bit arguments only
+ *
+ */
+static void format_record(const char *fmt, const uint32_t *args) {
+
+	char spec[32];
+	const char *start;
+	const char *text;
+	int arg = 0;
+	int len;
+
+	while (*fmt != '\0') {
+		if (*fmt != '%') {
+			if (*fmt != '\r' && *fmt != '\n') {	// one record per output line
+				putchar(*fmt);
+			}
+			fmt++;
+			continue;
+		}
+		if (fmt[1] == '%') {
+			putchar('%');
+			fmt += 2;
+			continue;
+		}
+
+		// copy the flags, width and precision, leave out the length modifiers
+		start = fmt++;
+		len = 1;
+		spec[0] = '%';
+		while (*fmt != '\0' && strchr("diouxXcsp", *fmt) == NULL) {
+			if (strchr("hlzjt", *fmt) == NULL && len < (int) sizeof(spec) - 2) {
+				spec[len++] = *fmt;
+			}
+			fmt++;
+		}
+		if (*fmt == '\0') {
+			fputs(start, stdout);
+			break;
+		}
+		spec[len++] = *fmt;
+		spec[len] = '\0';
+
+		if (arg == TRACE_MAX_ARGS) {
+			fputs("<?>", stdout);
+		} else if (*fmt == 's') {
+			text = elf_string(args[arg]);
+			if (text != NULL) {
+				printf(spec, text);
+			} else {
+				printf("<0x%08x>", args[arg]);
+			}
+		} else if (*fmt == 'd' || *fmt == 'i') {
+			printf(spec, (int32_t) args[arg]);
+		} else if (*fmt == 'c') {
+			printf(spec, (int) (char) args[arg]);
+		} else if (*fmt == 'p') {
+			printf("0x%08x", args[arg]);
+		} else {
+			printf(spec, args[arg]);
+		}
+		arg++;
+		fmt++;
+	}
+	putchar('\n');
+}
+
+int main(int argc, char **argv) {
+
+	unsigned long clockHz = 0;
+	char names[TRACE_RINGS][32];
+	char line[256];
+	char name[32];
+	FILE *capture;
+	int opt;
+	int ring;
+	uint32_t stamp;
+	uint32_t fmtAddr;
+	uint32_t args[TRACE_MAX_ARGS];
+	uint32_t lastStamp = 0;
+	double elapsed = 0;	// cycles since the first record
+	int records = 0;
+	int unknown = 0;
+	const char *fmt;
+
+	while ((opt = getopt(argc, argv, "f:")) != -1) {
+		switch (opt) {
+			case 'f':
+				clockHz = strtoul(optarg, NULL, 0);
+				break;
+			default:
+				optind = argc;
+				break;
+		}
+	}
+	if (optind != argc - 2) {
+		fprintf(stderr, "usage: %s [-f cpu_hz] firmware.elf capture.log\n", argv[0]);
+		return 1;
+	}
+	if (load_elf(argv[optind]) < 0) {
+		fprintf(stderr, "%s: not a 32 bit little endian ELF\n", argv[optind]);
+		return 1;
+	}
+	capture = fopen(argv[optind + 1], "r");
+	if (capture == NULL) {
+		perror(argv[optind + 1]);
+		return 1;
+	}
+
+	for (int i = 0; i < TRACE_RINGS; i++) {
+		snprintf(names[i], sizeof(names[i]), "task%d", i);
+	}
+
+	while (fgets(line, sizeof(line), capture) != NULL) {
+
+		if (sscanf(line, "#F %lu", &clockHz) == 1 && clockHz > 0) {
+			continue;
+		}
+		if (sscanf(line, "#N %d %31s", &ring, name) == 2 && ring >= 0 && ring < TRACE_RINGS) {
+			strcpy(names[ring], name);
+			continue;
+		}
+		if (sscanf(line, "#T %d %x %x %x %x %x %x", &ring, &stamp, &fmtAddr,
+				&args[0], &args[1], &args[2], &args[3]) != 7 || ring < 0 || ring >= TRACE_RINGS) {
+			continue;
+		}
+
+		// the cycle counter wraps every few seconds, records are sent in order so only step forward
+		if (records > 0) {
+			elapsed += (uint32_t) (stamp - lastStamp);
+		}
+		lastStamp = stamp;
+		records++;
+
+		if (clockHz > 0) {
+			printf("%12.3f ms %-16s ", elapsed * 1000.0 / clockHz, names[ring]);
+		} else {
+			printf("%14.0f cyc %-16s ", elapsed, names[ring]);
+		}
+
+		fmt = elf_string(fmtAddr);
+		if (fmt == NULL) {
+			printf("<unknown format 0x%08x> %08x %08x %08x %08x\n", fmtAddr, args[0], args[1], args[2], args[3]);
+			unknown++;
+		} else {
+			format_record(fmt, args);
+		}
+	}
+
+	fclose(capture);
+	fprintf(stderr, "%d records, %d with a format not in %s\n", records, unknown, argv[optind]);
+	free(elf);
+	return unknown != 0;
+}
@@ -0,0 +1,146 @@
+ /**
+ **************************************************************
+ * @file mylib/s4375116_CAG_density.c
+ * @author Sami Kaab - s4375116
+ * @date 19102026
+ * @brief zoomed out view of a game of life world bigger than the OLED
+ * Keeps a pyramid of live cell counts, level n holds one count per 2^n by 2^n
+ * block of cells. The simulator reports every cell that is born or dies so the
+ * pyramid never has to be rebuilt, and a level is drawn one pixel per block with
+ * ordered (4x4 Bayer) dithering by density.
+ * Draws into s4375116_oled_fb so it also builds on the host (see host/density_bench)
+ * REFERENCE: Bayer, "An optimum method for two-level rendition of continuous-tone pictures" (1973)
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4375116_lib_cag_density_init() - size the pyramid for a world, all cells dead
+ * s4375116_lib_cag_density_rebuild() - recount the pyramid from a whole world
+ * s4375116_lib_cag_density_change() - a cell was born (+1) or died (-1)
+ * s4375116_lib_cag_density_count() - live cells in a block
+ * s4375116_lib_cag_density_render() - draw a level into the OLED frame buffer
+ ***************************************************************
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "s4375116_oled_fb.h"
+#include "s4375116_CAG_density.h"
+
+/* 4x4 Bayer threshold matrix, a block lights up when its density is above (value + 0.5) / 16 */
+static const uint8_t bayer[4][4] = {
+	{ 0,  8,  2, 10},
+	{12,  4, 14,  6},
+	{ 3, 11,  1,  9},
+	{15,  7, 13,  5},
+};
+
+static uint16_t pool[CAG_DENSITY_POOL_SIZE];
+static uint16_t *levels[CAG_DENSITY_MAX_LEVEL + 1];	// counts of each level, row major (levels[0] unused)
+static int levelWidth[CAG_DENSITY_MAX_LEVEL + 1];	// blocks in a row of each level
+static int levelHeight[CAG_DENSITY_MAX_LEVEL + 1];
+static int levelCount;								// highest level kept
+static int worldWidth;
+static int worldHeight;
+
+/*
+ * Size the pyramid for a width by height world with every cell dead.
+ * Returns the highest level kept, or -1 if the pool is too small
+ */
+int s4375116_lib_cag_density_init(int width, int height) {
+
+	int used = 0;
+	int level;
+
+	levelCount = 0;
+	for (level = 1; level <= CAG_DENSITY_MAX_LEVEL; level++) {
+		levelWidth[level] = (width + (1 << level) - 1) >> level;
+		levelHeight[level] = (height + (1 << level) - 1) >> level;
+		if (used + levelWidth[level] * levelHeight[level] > CAG_DENSITY_POOL_SIZE) {
+			return -1;
+		}
+		levels[level] = &pool[used];
+		used += levelWidth[level] * levelHeight[level];
+		levelCount = level;
+		if (levelWidth[level] == 1 && levelHeight[level] == 1) {
+			break;
+		}
+	}
+
+	memset(pool, 0, used * sizeof(pool[0]));
+	worldWidth = width;
+	worldHeight = height;
+	return levelCount;
+}
+
+/*
+ * Recount the pyramid from a whole world of width * height cells (after a clear or a load)
+ */
+void s4375116_lib_cag_density_rebuild(const char *cells) {
+
+	s4375116_lib_cag_density_init(worldWidth, worldHeight);
+	for (int y = 0; y < worldHeight; y++) {
+		for (int x = 0; x < worldWidth; x++) {
+			if (cells[y * worldWidth + x]) {
+				s4375116_lib_cag_density_change(x, y, 1);
+			}
+		}
+	}
+}
+
+/*
+ * A cell was born (delta 1) or died (delta -1), updates one count per level
+ */
+void s4375116_lib_cag_density_change(int x, int y, int delta) {
+
+	for (int level = 1; level <= levelCount; level++) {
+		levels[level][(y >> level) * levelWidth[level] + (x >> level)] += delta;
+	}
+}
+
+/*
+ * Live cells in block (blockX, blockY) of a level, level 0 is not kept
+ */
+int s4375116_lib_cag_density_count(int level, int blockX, int blockY) {
+
+	if (level < 1 || level > levelCount || blockX < 0 || blockY < 0 ||
+			blockX >= levelWidth[level] || blockY >= levelHeight[level]) {
+		return 0;
+	}
+	return levels[level][blockY * levelWidth[level] + blockX];
+}
+
+/*
+ * Draw a level from block (blockX, blockY) at the top left of the panel, one pixel per block.
+ * Only the page column bytes that change are sent on the next flush
+ */
+void s4375116_lib_cag_density_render(int level, int blockX, int blockY, int pixelWidth, int pixelHeight) {
+
+	int pages = (pixelHeight + 7) / 8;
+	int area = 1 << (2 * level);	// cells in a block
+	uint8_t bits, mask;
+	int py;
+
+	if (level < 1 || level > levelCount) {
+		return;
+	}
+
+	for (int page = 0; page < pages; page++) {
+
+		// only touch the pixel rows of this page that belong to the view
+		mask = (pixelHeight - page * 8 >= 8) ? 0xFF : (1 << (pixelHeight - page * 8)) - 1;
+
+		for (int px = 0; px < pixelWidth; px++) {
+			bits = 0;
+			for (int b = 0; b < 8; b++) {
+				py = page * 8 + b;
+				// count / area > (bayer + 0.5) / 16
+				if (s4375116_lib_cag_density_count(level, blockX + px, blockY + py) * 32 >
+						(2 * bayer[py & 3][px & 3] + 1) * area) {
+					bits |= 1 << b;
+				}
+			}
+			s4375116_lib_oled_fb_put(px, page, bits, mask);
+		}
+	}
+}
@@ -0,0 +1,38 @@
+ /**
+ **************************************************************
+ * @file mylib/s4375116_CAG_density.h
+ * @author Sami Kaab - s4375116
+ * @date 19102026
+ * @brief zoomed out view of a game of life world bigger than the OLED
+ * Keeps a pyramid of live cell counts, level n holds one count per 2^n by 2^n
+ * block of cells. The simulator reports every cell that is born or dies so the
+ * pyramid never has to be rebuilt, and a level is drawn one pixel per block with
+ * ordered (4x4 Bayer) dithering by density.
+ * Draws into s4375116_oled_fb so it also builds on the host (see host/density_bench)
+ * REFERENCE: Bayer, "An optimum method for two-level rendition of continuous-tone pictures" (1973)
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4375116_lib_cag_density_init() - size the pyramid for a world, all cells dead
+ * s4375116_lib_cag_density_rebuild() - recount the pyramid from a whole world
+ * s4375116_lib_cag_density_change() - a cell was born (+1) or died (-1)
+ * s4375116_lib_cag_density_count() - live cells in a block
+ * s4375116_lib_cag_density_render() - draw a level into the OLED frame buffer
+ ***************************************************************
+ */
+
+#ifndef S4375116_CAG_DENSITY_H
+#define S4375116_CAG_DENSITY_H
+
+#ifndef CAG_DENSITY_POOL_SIZE
+#define CAG_DENSITY_POOL_SIZE	1024	// counts shared by all levels, a w by h world needs about w * h / 3
+#endif
+#define CAG_DENSITY_MAX_LEVEL	7		// largest block is 128 by 128 cells
+
+int s4375116_lib_cag_density_init(int width, int height);
+void s4375116_lib_cag_density_rebuild(const char *cells);
+void s4375116_lib_cag_density_change(int x, int y, int delta);
+int s4375116_lib_cag_density_count(int level, int blockX, int blockY);
+void s4375116_lib_cag_density_render(int level, int blockX, int blockY, int pixelWidth, int pixelHeight);
+
+#endif
@@ -9,6 +9,10 @@
  * EXTERNAL FUNCTIONS
  ***************************************************************
  * s4375116_tsk_cag_display_init - create the task that displays the CAG_simulation output
+ * s4375116_cag_display_frame_acquire - take a free frame buffer to draw the next grid into
+ * s4375116_cag_display_frame_publish - hand a finished frame buffer to the display task
+ * s4375116_cag_display_term - mirror the grid on the debug uart terminal
+ * s4375116_cag_display_draw - draw a frame on the oled outside the display task (bench command)
  ***************************************************************
  */
 
@@ -23,11 +27,33 @@
 #include "oled_pixel.h"
 #include "oled_string.h"
 #include "fonts.h"
+#include <stdio.h>
 
 #include "s4375116_oled.h"
 #include "s4375116_CAG_grid.h"
 #include "s4375116_CAG_simulator.h"
 #include "s4375116_CAG_display.h"
+#include "s4375116_CAG_render.h"
+#include "s4375116_oled_fb.h"
+#include "s4375116_CAG_recorder.h"
+#include "s4375116_CAG_term.h"
+#include "s4375116_latency.h"
+#include "s4375116_uart_tx.h"
+#include "s4375116_CAG_link.h"
+
+/* frame buffers passed by pointer between the cag simulator and the display */
+static CagDisplayTextMsg frames[CAGDISPLAY_FRAME_COUNT];
+
+/* status strip text fields, only characters that change are redrawn */
+static OledFbText statusCounts;
+static OledFbText statusRate;
+
+static unsigned long lastGeneration;	// generation of the last frame drawn
+static unsigned long rateGeneration;	// generation at the start of the rate window
+static TickType_t rateTick;				// start of the rate window
+
+static volatile int termView;	// terminal view requested
+static int termShown;			// terminal view currently drawn
 
 /**
  * @brief Draw border bounding the grid on the oled
@@ -51,33 +77,181 @@ void draw_grid_borders(void) {
     }
 }
 
+/**
+ * @brief Blank the status strip text fields
+ * 
+ */
+void status_init(void) {
+	s4375116_lib_oled_fb_text_init(&statusCounts, STATUS_X, STATUS_COUNTS_Y);
+	s4375116_lib_oled_fb_text_init(&statusRate, STATUS_X, STATUS_RATE_Y);
+}
+
 /**
  * @brief clear Oled display
  * 
  */
 void clear_display(void) {
-	ssd1306_Fill(Black);
-	ssd1306_UpdateScreen();
+	s4375116_lib_oled_fb_clear();
+	status_init();
+	s4375116_lib_oled_fb_flush();
 } 
 
 /**
- * @brief Draws the received grid on the oled
+ * @brief Update the generations per second shown in the status strip once a second
+ * 
+ */
+static void status_rate_update(void) {
+
+	char text[OLED_FB_TEXT_MAX + 1];
+	TickType_t currTick = xTaskGetTickCount();
+	unsigned long centiRate; // generations per 100 seconds
+
+	if ((currTick - rateTick) < configTICK_RATE_HZ) {
+		return;
+	}
+
+	if (lastGeneration < rateGeneration) { // grid was cleared during the window
+		rateGeneration = 0;
+	}
+	centiRate = ((lastGeneration - rateGeneration) * 100 * configTICK_RATE_HZ) / (currTick - rateTick);
+	snprintf(text, sizeof(text), "%lu.%02lu gen/s", centiRate / 100, centiRate % 100);
+	s4375116_lib_oled_fb_text_update(&statusRate, text);
+
+	rateGeneration = lastGeneration;
+	rateTick = currTick;
+}
+
+/**
+ * @brief Take a free frame buffer for the simulator to draw the next grid into
+ * 
+ * @return CagDisplayTextMsg* the frame, or NULL if every frame is still in use
+ */
+CagDisplayTextMsg *s4375116_cag_display_frame_acquire(void) {
+
+	CagDisplayTextMsg *frame = NULL;
+
+	if (CAGDisplayFreeQueue != NULL) {	// Check if queue exists
+		xQueueReceive(CAGDisplayFreeQueue, &frame, 0);
+	}
+	if (frame != NULL) {
+		frame->inputStamp = LATENCY_NONE;
+	}
+	return frame;
+}
+
+/**
+ * @brief Hand a finished frame to the display task and the recorder. A frame the display has not 
+ * picked up yet is superseded and goes straight back to the free pool.
+ * 
+ * @param frame frame previously returned by s4375116_cag_display_frame_acquire()
+ */
+void s4375116_cag_display_frame_publish(CagDisplayTextMsg *frame) {
+
+	CagDisplayTextMsg *staleFrame;
+	uint32_t now;
+
+	if (frame->inputStamp != LATENCY_NONE) {
+		now = s4375116_latency_now();
+		s4375116_latency_record(LATENCY_APPLIED_QUEUED, frame->stageStamp, now);
+		frame->stageStamp = now;
+	}
+
+	// the cli reads the recording from another task
+	vTaskSuspendAll();
+	s4375116_lib_cag_recorder_frame(&frame->grid[0][0], frame->generation);
+	xTaskResumeAll();
+
+	if (CAGDisplayMessageQueue != NULL) {	// Check if queue exists
+		if (xQueueReceive(CAGDisplayMessageQueue, &staleFrame, 0) == pdTRUE) {
+			// the key shown by the stale frame reaches the screen with this one
+			if (frame->inputStamp == LATENCY_NONE) {
+				frame->inputStamp = staleFrame->inputStamp;
+				frame->stageStamp = staleFrame->stageStamp;
+			}
+			xQueueSendToBack(CAGDisplayFreeQueue, &staleFrame, 0);
+		}
+		xQueueSendToBack(CAGDisplayMessageQueue, &frame, 0);
+	}
+}
+
+/**
+ * @brief Queue terminal output on the debug uart, waits for room as a partly sent update would garble the view
+ * 
+ * @param buf bytes to send
+ * @param len number of bytes
+ */
+void term_uart_write(const char *buf, int len) {
+	s4375116_uart_tx_write(buf, len, portMAX_DELAY);
+}
+
+/**
+ * @brief Turn the terminal view of the grid on or off, the display task draws it with the next frame
+ * 
+ * @param enable 1 to mirror the grid on the terminal
+ */
+void s4375116_cag_display_term(int enable) {
+	termView = enable;
+}
+
+/**
+ * @brief Draws the received grid in the oled frame buffer, sent by the next flush
+ * 
+ * @param frame the frame published by the simulator
+ */
+void display_to_oled(const CagDisplayTextMsg *frame) {
+
+	char text[OLED_FB_TEXT_MAX + 1];
+
+	s4375116_lib_cag_render_grid(&frame->grid[0][0], GRID_WIDTH, GRID_HEIGHT, CELL_SIZE);
+
+	snprintf(text, sizeof(text), "G:%lu P:%d", frame->generation, frame->population);
+	s4375116_lib_oled_fb_text_update(&statusCounts, text);
+	lastGeneration = frame->generation;
+}
+
+/**
+ * @brief Draw a frame on the oled from another task, the rate shown is left alone.
+ * Used by the bench command, which keeps the display task from running while it draws.
+ * 
+ * @param frame frame to draw
+ */
+void s4375116_cag_display_draw(const CagDisplayTextMsg *frame) {
+
+	unsigned long savedGeneration = lastGeneration;
+
+	display_to_oled(frame);
+	s4375116_lib_oled_fb_flush();
+	lastGeneration = savedGeneration;
+}
+
+/**
+ * @brief Start or stop the terminal view when it was requested
  * 
- * @param RcvdMsg 
  */
-void display_to_oled(CagDisplayTextMsg RcvdMsg) {
-	//Clear Screen
-	ssd1306_Fill(Black);
-	for(int y = 0; y < GRID_HEIGHT; y++) {                                           
-		for(int x = 0; x < GRID_WIDTH; x++) {  
-			// draw the cell which is 2 by 2 pixels
-		    ssd1306_DrawPixel(x*CELL_SIZE, y*CELL_SIZE, RcvdMsg.grid[y][x]);
-			ssd1306_DrawPixel(x*CELL_SIZE+1, y*CELL_SIZE, RcvdMsg.grid[y][x]);
-			ssd1306_DrawPixel(x*CELL_SIZE, y*CELL_SIZE+1, RcvdMsg.grid[y][x]);
-			ssd1306_DrawPixel(x*CELL_SIZE+1, y*CELL_SIZE+1, RcvdMsg.grid[y][x]);
-		}                                                                       
-	} 	
-	ssd1306_UpdateScreen();
+void term_view_update(void) {
+
+	if (termView && !termShown) {
+		s4375116_lib_cag_term_init(term_uart_write);
+		termShown = 1;
+	} else if (!termView && termShown) {
+		s4375116_lib_cag_term_release();
+		termShown = 0;
+	}
+}
+
+/**
+ * @brief Send the cells that changed to the terminal view
+ * 
+ * @param frame the frame published by the simulator
+ */
+void term_view_render(const CagDisplayTextMsg *frame) {
+
+	char text[CAG_TERM_STATUS_MAX + 1];
+
+	if (termShown) {
+		snprintf(text, sizeof(text), "G:%lu P:%d", frame->generation, frame->population);
+		s4375116_lib_cag_term_render(&frame->grid[0][0], GRID_WIDTH, GRID_HEIGHT, text);
+	}
 }
 
 /**
@@ -93,23 +267,49 @@ void s4375116TaskCAGDisplay(void) {
 
 	portENABLE_INTERRUPTS();	//Enable interrupts
 
+	status_init();
+	rateTick = xTaskGetTickCount();
+
 	EventBits_t uxBits;
 
-	CagDisplayTextMsg RcvdMsg; // message struct which holds the grid
-	
-	//queue to receive the game of life grid
-	CAGDisplayMessageQueue = xQueueCreate(1, sizeof(RcvdMsg));		// Create queue of length 10 Message items 
+	CagDisplayTextMsg *frame; // frame which holds the grid
+	BaseType_t received;
+	uint32_t screenStamp;
 
 	for(;;) {
 
 		if (CAGDisplayMessageQueue != NULL) {	// Check if queue exists
 
+			term_view_update();
+
 			// get updated grid from CAG simulator
-			if (xQueueReceive( CAGDisplayMessageQueue, &RcvdMsg, 10 )) {
-				portDISABLE_INTERRUPTS();	//Disable interrupts
+			received = xQueueReceive( CAGDisplayMessageQueue, &frame, 10 );
+
+			portDISABLE_INTERRUPTS();	//Disable interrupts
+			if (received) {
 				//drw grid on oled
-				display_to_oled(RcvdMsg);
-				portENABLE_INTERRUPTS();	//Enable interrupts
+				display_to_oled(frame);
+			}
+			status_rate_update();		// every pass, so the rate drops to 0 while paused
+			// only send what changed since the last flush
+			s4375116_lib_oled_fb_flush();
+			portENABLE_INTERRUPTS();	//Enable interrupts
+
+			if (received) {
+				// the oled update has finished
+				if (frame->inputStamp != LATENCY_NONE) {
+					screenStamp = s4375116_latency_now();
+					s4375116_latency_record(LATENCY_QUEUED_SCREEN, frame->stageStamp, screenStamp);
+					s4375116_latency_record(LATENCY_INPUT_SCREEN, frame->inputStamp, screenStamp);
+				}
+
+				term_view_render(frame);
+				if (s4375116_cag_link_streaming()) {
+					s4375116_cag_link_stream_frame(&frame->grid[0][0], frame->generation);
+				}
+
+				// release the frame so the simulator can draw into it again
+				xQueueSendToBack(CAGDisplayFreeQueue, &frame, 0);
 
         	}
 		}
@@ -134,6 +334,20 @@ void s4375116TaskCAGDisplay(void) {
  */
 void s4375116_tsk_cag_display_init(void) {
 
+	CagDisplayTextMsg *frame;
+
+	// queues hold frame pointers so the grid is never copied between tasks
+	CAGDisplayMessageQueue = xQueueCreate(1, sizeof(frame));
+	CAGDisplayFreeQueue = xQueueCreate(CAGDISPLAY_FRAME_COUNT, sizeof(frame));
+
+	for (int i = 0; i < CAGDISPLAY_FRAME_COUNT; i++) {
+		frame = &frames[i];
+		xQueueSendToBack(CAGDisplayFreeQueue, &frame, 0);
+	}
+
+	// every published frame is recorded from the start
+	s4375116_lib_cag_recorder_init(GRID_WIDTH, GRID_HEIGHT);
+
 	xTaskCreate( (void *) &s4375116TaskCAGDisplay, (const signed char *) "CAGDISPLAY", CAGDISPLAYTASK_STACK_SIZE, NULL, CAGDISPLAYTASK_PRIORITY, NULL );
 
 }
\ No newline at end of file
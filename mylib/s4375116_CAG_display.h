@@ -9,30 +9,51 @@
  * EXTERNAL FUNCTIONS
  ***************************************************************
  * s4375116_tsk_cag_display_init - create the task that displays the CAG_simulation output
+ * s4375116_cag_display_frame_acquire - take a free frame buffer to draw the next grid into
+ * s4375116_cag_display_frame_publish - hand a finished frame buffer to the display task
+ * s4375116_cag_display_term - mirror the grid on the debug uart terminal
+ * s4375116_cag_display_draw - draw a frame on the oled outside the display task (bench command)
  ***************************************************************
  */
 
 #ifndef S4375116_CAG_DISPLAY_H
 #define S4375116_CAG_DISPLAY_H
 
+#include <stdint.h>
+
 #define GRID_HEIGHT	16	// cells
 #define GRID_WIDTH	64	// cells
 #define CELL_SIZE	2	// a cell is 2 by 2 pixels
 
+#define STATUS_X			1	// status strip below the grid (pixels)
+#define STATUS_COUNTS_Y		(GRID_HEIGHT * CELL_SIZE + 6)	// generation and population
+#define STATUS_RATE_Y		(STATUS_COUNTS_Y + 13)			// generations per second
+
+#define CAGDISPLAY_FRAME_COUNT	3	// frame buffers shared by the simulator and the display (triple buffering)
+
 // Task Priorities (Idle Priority is the lowest priority)
 #define CAGDISPLAYTASK_PRIORITY					( tskIDLE_PRIORITY + 2 )
 
 // Task Stack Allocations (must be a multiple of the minimal stack size)
-#define CAGDISPLAYTASK_STACK_SIZE		( configMINIMAL_STACK_SIZE * 5 )
+#define CAGDISPLAYTASK_STACK_SIZE		( configMINIMAL_STACK_SIZE * 5 )	// snprintf of the oled and terminal text
 
-// struct to hold messgae contiaining grid from CAG simulator
+// struct to hold a frame containing the grid from CAG simulator
 struct cagDisplayTextMsg {
 	char grid[GRID_HEIGHT][GRID_WIDTH];
+	unsigned long generation;	// generations simulated since the grid was cleared
+	int population;				// number of live cells
+	uint32_t inputStamp;		// latency stamp of the key that caused this frame, LATENCY_NONE if none
+	uint32_t stageStamp;		// latency stamp of the last stage the frame went through
 };
 typedef struct cagDisplayTextMsg CagDisplayTextMsg;
 
-QueueHandle_t CAGDisplayMessageQueue;	// Queue used to receive message from cag simulator
+QueueHandle_t CAGDisplayMessageQueue;	// Queue of pointers to frames published by the cag simulator
+QueueHandle_t CAGDisplayFreeQueue;	// Queue of pointers to frames released by the display
 
 void s4375116_tsk_cag_display_init(void);
+CagDisplayTextMsg *s4375116_cag_display_frame_acquire(void);
+void s4375116_cag_display_frame_publish(CagDisplayTextMsg *frame);
+void s4375116_cag_display_term(int enable);
+void s4375116_cag_display_draw(const CagDisplayTextMsg *frame);
 
 #endif
\ No newline at end of file
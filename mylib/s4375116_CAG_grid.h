@@ -3,12 +3,14 @@
  * @file mylib/s4375116_CAG_grid.h
  * @author Sami Kaab - s4375116 
  * @date 14052022
- * @brief task function to get single character input from user and control simulator and display
+ * @brief single character input from the user to control the simulator and display
+ * Keys are passed in by the console task (s4375116_console.c) while in grid mode
  * REFERENCE: csse3010_project.pdf
  ***************************************************************
  * EXTERNAL FUNCTIONS
  ***************************************************************
- * s4375116_tsk_cag_grid_init - create the task that controls the simulator with user input
+ * s4375116_cag_grid_init - initialise the grid control
+ * s4375116_cag_grid_key - handle a key received in grid mode
  ***************************************************************
  */
 
@@ -35,12 +37,6 @@
 #include "s4375116_CAG_simulator.h"
 #include "s4375116_lta1000g.h"
 
-// Task Priorities 
-#define CAGGRIDTASK_PRIORITY			( tskIDLE_PRIORITY + 2 )
-
-// Task Stack Allocations 
-#define CAGGRIDTASK_STACK_SIZE		( configMINIMAL_STACK_SIZE * 2 )
-
 #define EVT_MV_UP			1 << 0		//W Event Flag
 #define EVT_MV_LEFT			1 << 1		//A Event Flag
 #define EVT_MV_DOWN			1 << 2		//S Event Flag
@@ -55,12 +51,12 @@
 #define GRID_CTRL_EVENT ( EVT_MV_UP | EVT_MV_LEFT | EVT_MV_DOWN | EVT_MV_RIGHT | EVT_SLCT_CELL | EVT_USLCT_CELL | EVT_START_STOP | EVT_MV_ORIGIN | EVT_CLR_GRID )//Control Event Group Mask
 
 EventGroupHandle_t gridctrlEventGroup;		//Control Event Group
-SemaphoreHandle_t gridModeSemaphore;	// Semaphore for pushbutton 
 EventBits_t uxBits;
 caMessage_t sendCaMessage;
 
 
 
-void s4375116_tsk_cag_grid_init(void);
+void s4375116_cag_grid_init(void);
+void s4375116_cag_grid_key(char currChar);
 
 #endif
\ No newline at end of file
@@ -12,6 +12,8 @@
  ***************************************************************
  */
 
+#include <stdlib.h>
+
 #include "board.h"
 #include "processor_hal.h"
 #include "debug_log.h"
@@ -30,14 +32,16 @@
 #include "s4375116_joystick.h"
 #include "s4375116_CAG_joystick.h"
 #include "s4375116_CAG_grid.h"
+#include "s4375116_CAG_simulator.h"
+#include "s4375116_debounce.h"
+
+/* generation period (ms) at every 16th of the y axis travel (bottom to top), turbo to 10s on a log scale
+   (20 * 500^(i/16)), linear in between */
+static const unsigned int yPeriods[17] = {20, 29, 43, 64, 95, 139, 206, 303, 447, 659, 972, 1434, 2115, 3118, 4599, 6781, 10000};
 
-unsigned int adcYThreshold10 = 4080;
-unsigned int adcYThreshold5 = 3000;
-unsigned int adcYThreshold2 = 1000;
-unsigned int adcXThresholdPause = 1000;
-unsigned int adcXThresholdStart = 3000;
-int adcXOffset = 35;
-int adcYOffset = 35;
+/* x thresholds in calibrated units (-JOYSTICK_NORM_MAX to JOYSTICK_NORM_MAX) */
+int adcXThresholdPause = -JOYSTICK_NORM_MAX / 2;
+int adcXThresholdStart = JOYSTICK_NORM_MAX / 2;
 
 /**
  * @brief initialise the necessary hardware components
@@ -55,81 +59,90 @@ void cag_joystick_hardware_init(void) {
 }
 
 /**
- * @brief cyclic executive for the joystick cag task
+ * @brief Map the y axis to a generation period
  * 
+ * @param adcValueY calibrated y reading (-JOYSTICK_NORM_MAX to JOYSTICK_NORM_MAX)
+ * @return int period (ms)
  */
-void s4375116TaskCAGJoystick(void) {
+int y_to_period(int adcValueY) {
 
-	cag_joystick_hardware_init();
+	// position along the table, 8 fraction bits
+	unsigned int pos = ((adcValueY + JOYSTICK_NORM_MAX) * (16 << 8)) / (2 * JOYSTICK_NORM_MAX);
+	unsigned int i = pos >> 8;
+	unsigned int frac = pos & 0xFF;
 
-	EventBits_t uxBits;
+	if (i >= 16) {
+		return yPeriods[16];
+	}
+	return yPeriods[i] + (((yPeriods[i + 1] - yPeriods[i]) * frac) >> 8);
+}
 
-	adcMessage_t rcvdAdcMessage; // message struct which holds the joystick adc values
-	//queue to receive the joystick adc values
-	joystickMessageQueue = xQueueCreate(50, sizeof(rcvdAdcMessage));
+/**
+ * @brief cyclic executive for the joystick cag task, sleeps until the joystick moves or its pushbutton is pressed.
+ * X starts and pauses the simulation, Y sets the generation period.
+ * 
+ */
+void s4375116TaskCAGJoystick(void) {
 
-	// Create Event Group
-	joystickctrlEventGroup = xEventGroupCreate();
-	
+	cag_joystick_hardware_init();
 
-	unsigned int adcValueX = 0; // Holds the adc value for the x axis
-	unsigned int adcValueY = 0; // Holds the adc value for the y axis
+	adcMessage_t rcvdAdcMessage; // message struct which holds the joystick adc values
+	DebounceEvent pbEvent; // debounced joystick pushbutton event
+	QueueSetMemberHandle_t activeQueue;
 
-	unsigned int lastAdcValueX = 0; // Holds the adc value for the x axis
-	unsigned int lastAdcValueY = 0; // Holds the adc value for the y axis
+	int adcValueX = 0; // Holds the calibrated value for the x axis
+	int adcValueY = 0; // Holds the calibrated value for the y axis
 
-	uxBits = xEventGroupClearBits(gridctrlEventGroup, EVT_CLR_GRID);
+	int xZone = 0; // 1 after starting, -1 after pausing, 0 once back in the middle
+	int periodAdcY = 0; // y value the period was last set from
+	int periodSet = 0; // 0 before the first reading
+	int period = 0;
 
 	for(;;) {
 
+		activeQueue = xQueueSelectFromSet(joystickQueueSet, portMAX_DELAY);
+
 		//check if joystick pushbutton was pressed
-		if (LTpbSemaphore != NULL) {	// Check if semaphore exists
-			/* See if we can obtain the PB semaphore. If the semaphore is not available
-			wait 10 ticks to see if it becomes free. */
-			if( xSemaphoreTake( LTpbSemaphore, 10 ) == pdTRUE ) {
+		if (activeQueue == joystickPbEventQueue) {
+			if (xQueueReceive( joystickPbEventQueue, &pbEvent, 0 ) == pdTRUE && pbEvent.type == DEBOUNCE_PRESS) {
 	
-				uxBits = xEventGroupSetBits(gridctrlEventGroup, EVT_CLR_GRID);
+				s4375116_cag_simulator_command(CA_CMD_CLEAR, 0, 0);
 
 			}
-
+			continue;
 		}
 
 		//read adc value for the queue
-		if (joystickMessageQueue != NULL) {	// Check if queue exists
-			// Check for item received - block atmost for 10 ticks
-			if (xQueueReceive( joystickMessageQueue, &rcvdAdcMessage, 10 )) {
-				// Get x and y adc value from the joystick
-				adcValueX = rcvdAdcMessage.adcX;
-				adcValueY = rcvdAdcMessage.adcY;
-			}
-		} 
-
-
-		//deal with adc x values
-		if (adcValueX > adcXThresholdStart && lastAdcValueX < adcXThresholdStart) {
-			// the joystick is has gone to its maximum x position and the simulator is pause, so start it again
-			uxBits = xEventGroupSetBits(joystickctrlEventGroup, EVT_START);
-		} else if (adcValueX < adcXThresholdPause && lastAdcValueX > adcXThresholdPause) {
-			// the joystick is has gone to its minimum x position and the simulator is running, so pause it
-			uxBits = xEventGroupSetBits(joystickctrlEventGroup, EVT_STOP);
+		if (xQueueReceive( joystickMessageQueue, &rcvdAdcMessage, 0 ) != pdTRUE) {
+			continue;
 		}
-
-		//deal with adc y values
-		if (adcValueY > adcYThreshold10 && lastAdcValueY < adcYThreshold10) {
-			uxBits = xEventGroupSetBits(joystickctrlEventGroup, EVT_UPDATE_TIME_10);
-		} else if (adcValueY > adcYThreshold5 && adcValueY < adcYThreshold10 && (lastAdcValueY < adcYThreshold5 || lastAdcValueY > adcYThreshold10)) {
-			uxBits = xEventGroupSetBits(joystickctrlEventGroup, EVT_UPDATE_TIME_5);
-		} else if (adcValueY > adcYThreshold2 && adcValueY < adcYThreshold5 && (lastAdcValueY < adcYThreshold2 || lastAdcValueY > adcYThreshold5)) {
-			uxBits = xEventGroupSetBits(joystickctrlEventGroup, EVT_UPDATE_TIME_2);
-		} else if (adcValueY < adcYThreshold2 && lastAdcValueY > adcYThreshold2) {
-			uxBits = xEventGroupSetBits(joystickctrlEventGroup, EVT_UPDATE_TIME_1);
+		// Get x and y adc value from the joystick
+		adcValueX = rcvdAdcMessage.adcX;
+		adcValueY = rcvdAdcMessage.adcY;
+
+		//deal with adc x values, each end acts once until the stick comes back past the hysteresis
+		if (adcValueX > adcXThresholdStart && xZone != 1) {
+			// the joystick is has gone to its maximum x position, start the simulation
+			s4375116_cag_simulator_command(CA_CMD_START, 0, 0);
+			xZone = 1;
+		} else if (adcValueX < adcXThresholdPause && xZone != -1) {
+			// the joystick is has gone to its minimum x position, pause the simulation
+			s4375116_cag_simulator_command(CA_CMD_STOP, 0, 0);
+			xZone = -1;
+		} else if ((xZone == 1 && adcValueX < adcXThresholdStart - CAGJOYSTICK_X_HYSTERESIS) ||
+				(xZone == -1 && adcValueX > adcXThresholdPause + CAGJOYSTICK_X_HYSTERESIS)) {
+			xZone = 0;
 		}
-		// update adc values
-		lastAdcValueX = adcValueX;
-		lastAdcValueY = adcValueY;
 
-		// Delay the task for 100ms.
-		vTaskDelay(100);
+		//deal with adc y values, ignore changes smaller than the hysteresis so noise does not flood the simulator
+		if (!periodSet || abs(adcValueY - periodAdcY) > CAGJOYSTICK_Y_HYSTERESIS) {
+			periodAdcY = adcValueY;
+			periodSet = 1;
+			if (y_to_period(adcValueY) != period) {
+				period = y_to_period(adcValueY);
+				s4375116_cag_simulator_command(CA_CMD_PERIOD, period, 0);
+			}
+		}
 	}
 }
 
@@ -138,7 +151,19 @@ void s4375116TaskCAGJoystick(void) {
  * 
  */
 void s4375116_tsk_cag_joystick_init(void) {
-	
+
+	adcMessage_t rcvdAdcMessage;
+
+	//queue to receive the joystick adc values
+	joystickMessageQueue = xQueueCreate(CAGJOYSTICK_QUEUE_LENGTH, sizeof(rcvdAdcMessage));
+
+	// wait on the adc values and the pushbutton events together (s4375116_tsk_joystick_init() creates the pushbutton queue)
+	joystickQueueSet = xQueueCreateSet(CAGJOYSTICK_QUEUE_LENGTH + JOYSTICK_PB_QUEUE_LENGTH);
+	xQueueAddToSet(joystickMessageQueue, joystickQueueSet);
+	if (joystickPbEventQueue != NULL) {	// Check if queue exists
+		xQueueAddToSet(joystickPbEventQueue, joystickQueueSet);
+	}
+
 	xTaskCreate( (void *) &s4375116TaskCAGJoystick, (const signed char *) "CAGJOYSTICK", CAGJOYSTICKTASK_STACK_SIZE, NULL, CAGJOYSTICKTASK_PRIORITY, &xJoystickCagTaskHandle );
 
 }
\ No newline at end of file
@@ -21,18 +21,13 @@
 // Task Stack Allocations (must be a multiple of the minimal stack size)
 #define CAGJOYSTICKTASK_STACK_SIZE		( configMINIMAL_STACK_SIZE * 2 )
 
-#define EVT_START			1 << 0
-#define EVT_STOP			1 << 1
-#define EVT_UPDATE_TIME_1	1 << 2
-#define EVT_UPDATE_TIME_2	1 << 3
-#define EVT_UPDATE_TIME_5	1 << 4
-#define EVT_UPDATE_TIME_10	1 << 5
+#define CAGJOYSTICK_QUEUE_LENGTH		10
 
-#define JOYSTICK_CTRL_EVENT ( EVT_START | EVT_STOP | EVT_UPDATE_TIME_1 | EVT_UPDATE_TIME_2 | EVT_UPDATE_TIME_5 | EVT_UPDATE_TIME_10)//Control Event Group Mask
+// in calibrated units, JOYSTICK_NORM_MAX from the centre to either end
+#define CAGJOYSTICK_X_HYSTERESIS		100		// how far the stick must come back before start/pause act again
+#define CAGJOYSTICK_Y_HYSTERESIS		16		// smallest y change that changes the period
 
-EventGroupHandle_t joystickctrlEventGroup;		//Control Event Group
-
-// message containing the joystick adc x and y value
+// message containing the joystick x and y value, calibrated (s4375116_joystick_normalise)
 struct adcMessage {
 	int adcX;
 	int adcY;
@@ -40,6 +35,7 @@ struct adcMessage {
 typedef struct adcMessage adcMessage_t;
 
 QueueHandle_t joystickMessageQueue;	// Queue used to receive adc values from the joystick
+QueueSetHandle_t joystickQueueSet;	// adc values and joystick pushbutton events
 TaskHandle_t xJoystickCagTaskHandle; // handle for the joystick task
 
 
@@ -0,0 +1,199 @@
+ /**
+ **************************************************************
+ * @file mylib/s4375116_CAG_link.c
+ * @author Sami Kaab - s4375116
+ * @date 19102026
+ * @brief Host link, carries out the frames of s4375116_CAG_proto received on the debug uart
+ * The console task hands every received byte to s4375116_cag_link_input() first,
+ * bytes that are not part of a frame go on to the grid keys or the cli.
+ * Uploads and downloads go through the simulator task so they fall between generations.
+ * Every frame is written to the uart ring in one go, so log output never splits one.
+ * REFERENCE: csse3010_project.pdf
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4375116_cag_link_input() - take a received byte if it belongs to a frame
+ * s4375116_cag_link_send() - send a frame to the host
+ * s4375116_cag_link_streaming() - the host asked for every displayed generation
+ * s4375116_cag_link_stream_frame() - send a displayed generation to the host
+ ***************************************************************
+ */
+
+#include "board.h"
+#include "processor_hal.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "event_groups.h"
+
+#include "s4375116_CAG_display.h"
+#include "s4375116_CAG_simulator.h"
+#include "s4375116_CAG_proto.h"
+#include "s4375116_CAG_link.h"
+#include "s4375116_uart_tx.h"
+
+static CagProtoParser parser;		// frame being received, only used by the console task
+static TickType_t lastByteTick;
+static volatile int streaming = 0;	// send every displayed generation
+
+/*
+ * Send a frame to the host, waiting up to wait ticks for room in the uart ring (dropped otherwise)
+ */
+void s4375116_cag_link_send(int type, const uint8_t *payload, int len, TickType_t wait) {
+
+	uint8_t frame[CAG_PROTO_MAX_FRAME];
+
+	len = s4375116_lib_cag_proto_encode(frame, type, payload, len);
+	s4375116_uart_tx_write((const char *) frame, len, wait);
+}
+
+/**
+ * @brief Acknowledge a frame
+ * 
+ * @param type type of the frame
+ * @param status CAG_PROTO_OK or an error
+ */
+void link_ack(int type, int status) {
+
+	uint8_t payload[2] = {type, status};
+
+	s4375116_cag_link_send(CAG_PROTO_ACK, payload, sizeof(payload), CAG_LINK_REPLY_WAIT);
+}
+
+/**
+ * @brief Check a command from the host is one the cli or joystick could send.
+ * The load and download commands are only sent by the link itself
+ *
+ * @return int 1 if the command may be passed to the simulator
+ */
+int link_command_allowed(int type) {
+
+	switch (type) {
+	case CA_CMD_START:
+	case CA_CMD_STOP:
+	case CA_CMD_START_STOP:
+	case CA_CMD_PERIOD:
+	case CA_CMD_CLEAR:
+	case CA_CMD_KILL:
+	case CA_CMD_SPAWN:
+	case 0x20: case 0x21: case 0x22:	// still lifes
+	case 0x30: case 0x31: case 0x32:	// oscillators
+	case 0x40:							// glider
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+/**
+ * @brief Carry out a received frame
+ * 
+ */
+void link_dispatch(void) {
+
+	int x;
+	int y;
+
+	switch (parser.type) {
+	case CAG_PROTO_PING:
+		link_ack(parser.type, CAG_PROTO_OK);
+		break;
+	case CAG_PROTO_UPLOAD:
+		if (parser.length != CAG_PROTO_GRID_SIZE(GRID_WIDTH, GRID_HEIGHT) ||
+				parser.payload[0] != GRID_WIDTH || parser.payload[1] != GRID_HEIGHT) {
+			link_ack(parser.type, CAG_PROTO_ERR_LENGTH);
+		} else {
+			link_ack(parser.type, (s4375116_cag_simulator_load(parser.payload, parser.length) == 0) ?
+					CAG_PROTO_OK : CAG_PROTO_ERR_BUSY);
+		}
+		break;
+	case CAG_PROTO_DOWNLOAD:
+		// the simulator answers with the grid
+		if (xSimulatorCagTaskHandle == NULL) {
+			link_ack(parser.type, CAG_PROTO_ERR_BUSY);
+		} else {
+			s4375116_cag_simulator_command(CA_CMD_DOWNLOAD, 0, 0);
+		}
+		break;
+	case CAG_PROTO_STREAM:
+		if (parser.length != 1) {
+			link_ack(parser.type, CAG_PROTO_ERR_LENGTH);
+		} else {
+			streaming = (parser.payload[0] != 0);
+			link_ack(parser.type, CAG_PROTO_OK);
+		}
+		break;
+	case CAG_PROTO_COMMAND:
+		if (parser.length != 5) {
+			link_ack(parser.type, CAG_PROTO_ERR_LENGTH);
+		} else {
+			x = (int16_t) (parser.payload[1] | (parser.payload[2] << 8));
+			y = (int16_t) (parser.payload[3] | (parser.payload[4] << 8));
+			if (!link_command_allowed(parser.payload[0])) {
+				link_ack(parser.type, CAG_PROTO_ERR_TYPE);
+				break;
+			}
+			if (parser.payload[0] == CA_CMD_PERIOD) {	// a period of 0 would never let the simulator block
+				x = (x < CAGSIMULATOR_MIN_PERIOD) ? CAGSIMULATOR_MIN_PERIOD :
+						((x > CAGSIMULATOR_MAX_PERIOD) ? CAGSIMULATOR_MAX_PERIOD : x);
+			}
+			s4375116_cag_simulator_command(parser.payload[0], x, y);
+			link_ack(parser.type, CAG_PROTO_OK);
+		}
+		break;
+	default:
+		link_ack(parser.type, CAG_PROTO_ERR_TYPE);
+		break;
+	}
+}
+
+/*
+ * Take a received byte if it starts or continues a frame, returns 0 for any other byte.
+ * A frame left incomplete for CAG_LINK_TIMEOUT_MS is dropped.
+ */
+int s4375116_cag_link_input(char c) {
+
+	int result;
+
+	if (parser.state != 0 && (xTaskGetTickCount() - lastByteTick) > pdMS_TO_TICKS(CAG_LINK_TIMEOUT_MS)) {
+		s4375116_lib_cag_proto_reset(&parser);
+	}
+	if (parser.state == 0 && (uint8_t) c != CAG_PROTO_SYNC) {
+		return 0;
+	}
+	lastByteTick = xTaskGetTickCount();
+
+	result = s4375116_lib_cag_proto_feed(&parser, (uint8_t) c);
+	if (result == CAG_PROTO_FRAME) {
+		link_dispatch();
+	} else if (result == CAG_PROTO_BAD_CRC) {
+		link_ack(parser.type, CAG_PROTO_ERR_CRC);
+	} else if (result == CAG_PROTO_BAD_LENGTH) {
+		link_ack(parser.type, CAG_PROTO_ERR_LENGTH);
+	}
+	return 1;
+}
+
+/*
+ * The host asked for every displayed generation
+ */
+int s4375116_cag_link_streaming(void) {
+	return streaming;
+}
+
+/*
+ * Send a displayed generation to the host, dropped if the uart is behind so the display never waits.
+ * Only the display task streams, so the buffers are static rather than on its stack
+ */
+void s4375116_cag_link_stream_frame(const char *cells, uint32_t generation) {
+
+	static uint8_t payload[CAG_PROTO_GRID_SIZE(GRID_WIDTH, GRID_HEIGHT)];
+	static uint8_t frame[CAG_PROTO_MAX_FRAME];
+	int len;
+
+	len = s4375116_lib_cag_proto_pack_grid(payload, cells, GRID_WIDTH, GRID_HEIGHT, generation);
+	len = s4375116_lib_cag_proto_encode(frame, CAG_PROTO_GRID, payload, len);
+	s4375116_uart_tx_write((const char *) frame, len, 0);
+}
@@ -0,0 +1,33 @@
+ /**
+ **************************************************************
+ * @file mylib/s4375116_CAG_link.h
+ * @author Sami Kaab - s4375116
+ * @date 19102026
+ * @brief Host link, carries out the frames of s4375116_CAG_proto received on the debug uart
+ * The console task hands every received byte to s4375116_cag_link_input() first,
+ * bytes that are not part of a frame go on to the grid keys or the cli.
+ * REFERENCE: csse3010_project.pdf
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4375116_cag_link_input() - take a received byte if it belongs to a frame
+ * s4375116_cag_link_send() - send a frame to the host
+ * s4375116_cag_link_streaming() - the host asked for every displayed generation
+ * s4375116_cag_link_stream_frame() - send a displayed generation to the host
+ ***************************************************************
+ */
+
+#ifndef S4375116_CAG_LINK_H
+#define S4375116_CAG_LINK_H
+
+#include <stdint.h>
+
+#define CAG_LINK_TIMEOUT_MS		100		// gap that ends a partly received frame
+#define CAG_LINK_REPLY_WAIT		pdMS_TO_TICKS(100)	// longest wait for room in the uart ring for a reply
+
+int s4375116_cag_link_input(char c);
+void s4375116_cag_link_send(int type, const uint8_t *payload, int len, TickType_t wait);
+int s4375116_cag_link_streaming(void);
+void s4375116_cag_link_stream_frame(const char *cells, uint32_t generation);
+
+#endif
@@ -51,7 +51,6 @@ void s4375116TaskCAGMnemonic( void ) {
     /* Register CLI commands */
 	s4375116_cli_mnemonic_init();
 	
-	drawLifeSemaphore = xSemaphoreCreateBinary();
 	deleteTaskSemaphore = xSemaphoreCreateBinary();
 
 	for (;;) {
@@ -24,7 +24,6 @@
 // Task Stack Allocations 
 #define CAGMNEMONICTASK_STACK_SIZE		( configMINIMAL_STACK_SIZE * 2 )
 
-SemaphoreHandle_t drawLifeSemaphore;	// Semaphore for pushbutton 
 SemaphoreHandle_t deleteTaskSemaphore;	// Semaphore for pushbutton 
 
 
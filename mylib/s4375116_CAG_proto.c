@@ -0,0 +1,185 @@
+ /**
+ **************************************************************
+ * @file mylib/s4375116_CAG_proto.c
+ * @author Sami Kaab - s4375116
+ * @date 19102026
+ * @brief Framed binary protocol between the host and the game of life board
+ * Frames share the debug uart with the cli and the logs:
+ *  0xA5 type length(2 bytes, little endian) payload crc(2 bytes, little endian)
+ * crc is CRC-16/CCITT-FALSE of type, length and payload. 0xA5 never appears in
+ * typed text, so the receiver can tell a frame from keys.
+ * Grids are packed as in s4375116_CAG_recorder: width height generation(4 bytes)
+ * then cell n (row by row) in bit (n % 8) of byte (n / 8).
+ * Builds on the host too (see host/cag_link).
+ * REFERENCE: CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF)
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4375116_lib_cag_proto_crc16() - add bytes to a CRC-16/CCITT-FALSE
+ * s4375116_lib_cag_proto_reset() - drop any partly received frame
+ * s4375116_lib_cag_proto_feed() - add a received byte to the frame being received
+ * s4375116_lib_cag_proto_encode() - build a frame
+ * s4375116_lib_cag_proto_pack_grid() - pack a grid into a grid payload
+ * s4375116_lib_cag_proto_unpack_grid() - unpack a grid payload
+ ***************************************************************
+ */
+
+#include <string.h>
+
+#include "s4375116_CAG_proto.h"
+
+// parser states, the field expected next
+#define PROTO_SYNC		0
+#define PROTO_TYPE		1
+#define PROTO_LEN_LO	2
+#define PROTO_LEN_HI	3
+#define PROTO_PAYLOAD	4
+#define PROTO_CRC_LO	5
+#define PROTO_CRC_HI	6
+
+/*
+ * Add bytes to a CRC-16/CCITT-FALSE, start with crc 0xFFFF
+ */
+uint16_t s4375116_lib_cag_proto_crc16(uint16_t crc, const uint8_t *data, int len) {
+
+	for (int i = 0; i < len; i++) {
+		crc ^= (uint16_t) data[i] << 8;
+		for (int bit = 0; bit < 8; bit++) {
+			crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+		}
+	}
+	return crc;
+}
+
+/*
+ * Drop any partly received frame, the next frame starts at a sync byte
+ */
+void s4375116_lib_cag_proto_reset(CagProtoParser *parser) {
+	parser->state = PROTO_SYNC;
+}
+
+/*
+ * Add a received byte to the frame being received. Bytes outside a frame are ignored
+ * up to the sync byte. Returns CAG_PROTO_FRAME once a whole valid frame is in parser
+ * (type, length, payload), CAG_PROTO_BAD_CRC or CAG_PROTO_BAD_LENGTH when a frame is
+ * dropped, CAG_PROTO_MORE otherwise
+ */
+int s4375116_lib_cag_proto_feed(CagProtoParser *parser, uint8_t byte) {
+
+	uint8_t header[3];
+
+	switch (parser->state) {
+	case PROTO_SYNC:
+		if (byte == CAG_PROTO_SYNC) {
+			parser->state = PROTO_TYPE;
+		}
+		break;
+	case PROTO_TYPE:
+		parser->type = byte;
+		parser->state = PROTO_LEN_LO;
+		break;
+	case PROTO_LEN_LO:
+		parser->length = byte;
+		parser->state = PROTO_LEN_HI;
+		break;
+	case PROTO_LEN_HI:
+		parser->length |= byte << 8;
+		parser->count = 0;
+		if (parser->length > CAG_PROTO_MAX_PAYLOAD) {
+			parser->state = PROTO_SYNC;
+			return CAG_PROTO_BAD_LENGTH;
+		}
+		parser->state = (parser->length > 0) ? PROTO_PAYLOAD : PROTO_CRC_LO;
+		break;
+	case PROTO_PAYLOAD:
+		parser->payload[parser->count++] = byte;
+		if (parser->count == parser->length) {
+			parser->state = PROTO_CRC_LO;
+		}
+		break;
+	case PROTO_CRC_LO:
+		parser->crc = byte;
+		parser->state = PROTO_CRC_HI;
+		break;
+	case PROTO_CRC_HI:
+		parser->crc |= byte << 8;
+		parser->state = PROTO_SYNC;
+
+		header[0] = parser->type;
+		header[1] = parser->length & 0xFF;
+		header[2] = parser->length >> 8;
+		if (parser->crc != s4375116_lib_cag_proto_crc16(s4375116_lib_cag_proto_crc16(0xFFFF, header, 3),
+				parser->payload, parser->length)) {
+			return CAG_PROTO_BAD_CRC;
+		}
+		return CAG_PROTO_FRAME;
+	}
+	return CAG_PROTO_MORE;
+}
+
+/*
+ * Build a frame of len (at most CAG_PROTO_MAX_PAYLOAD) payload bytes into frame,
+ * which must hold CAG_PROTO_OVERHEAD more bytes. Returns the frame length
+ */
+int s4375116_lib_cag_proto_encode(uint8_t *frame, int type, const uint8_t *payload, int len) {
+
+	uint16_t crc;
+
+	frame[0] = CAG_PROTO_SYNC;
+	frame[1] = type;
+	frame[2] = len & 0xFF;
+	frame[3] = len >> 8;
+	if (len > 0) {
+		memcpy(&frame[4], payload, len);
+	}
+	crc = s4375116_lib_cag_proto_crc16(0xFFFF, &frame[1], len + 3);
+	frame[4 + len] = crc & 0xFF;
+	frame[5 + len] = crc >> 8;
+	return len + CAG_PROTO_OVERHEAD;
+}
+
+/*
+ * Pack a width by height grid (non zero cells alive) into a grid payload.
+ * Returns the payload length, CAG_PROTO_GRID_SIZE(width, height)
+ */
+int s4375116_lib_cag_proto_pack_grid(uint8_t *payload, const char *cells, int width, int height, uint32_t generation) {
+
+	uint8_t *bits = &payload[CAG_PROTO_GRID_HEADER];
+
+	payload[0] = width;
+	payload[1] = height;
+	for (int i = 0; i < 4; i++) {
+		payload[2 + i] = (generation >> (8 * i)) & 0xFF;
+	}
+
+	memset(bits, 0, (width * height + 7) / 8);
+	for (int cell = 0; cell < width * height; cell++) {
+		if (cells[cell]) {
+			bits[cell >> 3] |= 1 << (cell & 7);
+		}
+	}
+	return CAG_PROTO_GRID_SIZE(width, height);
+}
+
+/*
+ * Unpack a grid payload into cells (0 or 1). Returns 0, or -1 if the payload length does not
+ * match its size or the grid has more than maxCells cells
+ */
+int s4375116_lib_cag_proto_unpack_grid(const uint8_t *payload, int len, char *cells, int maxCells,
+		int *width, int *height, uint32_t *generation) {
+
+	const uint8_t *bits = &payload[CAG_PROTO_GRID_HEADER];
+
+	if (len < CAG_PROTO_GRID_HEADER || len != CAG_PROTO_GRID_SIZE(payload[0], payload[1]) ||
+			payload[0] * payload[1] > maxCells) {
+		return -1;
+	}
+	*width = payload[0];
+	*height = payload[1];
+	*generation = payload[2] | (payload[3] << 8) | (payload[4] << 16) | ((uint32_t) payload[5] << 24);
+
+	for (int cell = 0; cell < *width * *height; cell++) {
+		cells[cell] = (bits[cell >> 3] >> (cell & 7)) & 0x01;
+	}
+	return 0;
+}
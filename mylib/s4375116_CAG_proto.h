@@ -0,0 +1,81 @@
+ /**
+ **************************************************************
+ * @file mylib/s4375116_CAG_proto.h
+ * @author Sami Kaab - s4375116
+ * @date 19102026
+ * @brief Framed binary protocol between the host and the game of life board
+ * Frames share the debug uart with the cli and the logs:
+ *  0xA5 type length(2 bytes, little endian) payload crc(2 bytes, little endian)
+ * crc is CRC-16/CCITT-FALSE of type, length and payload. 0xA5 never appears in
+ * typed text, so the receiver can tell a frame from keys.
+ * Grids are packed as in s4375116_CAG_recorder: width height generation(4 bytes)
+ * then cell n (row by row) in bit (n % 8) of byte (n / 8).
+ * Builds on the host too (see host/cag_link).
+ * REFERENCE: CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF)
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4375116_lib_cag_proto_crc16() - add bytes to a CRC-16/CCITT-FALSE
+ * s4375116_lib_cag_proto_reset() - drop any partly received frame
+ * s4375116_lib_cag_proto_feed() - add a received byte to the frame being received
+ * s4375116_lib_cag_proto_encode() - build a frame
+ * s4375116_lib_cag_proto_pack_grid() - pack a grid into a grid payload
+ * s4375116_lib_cag_proto_unpack_grid() - unpack a grid payload
+ ***************************************************************
+ */
+
+#ifndef S4375116_CAG_PROTO_H
+#define S4375116_CAG_PROTO_H
+
+#include <stdint.h>
+
+#define CAG_PROTO_SYNC			0xA5
+#define CAG_PROTO_OVERHEAD		6		// sync, type, length and crc
+#define CAG_PROTO_MAX_PAYLOAD	256
+#define CAG_PROTO_MAX_FRAME		(CAG_PROTO_MAX_PAYLOAD + CAG_PROTO_OVERHEAD)
+#define CAG_PROTO_GRID_HEADER	6		// width height generation
+#define CAG_PROTO_GRID_SIZE(w, h)	(CAG_PROTO_GRID_HEADER + ((w) * (h) + 7) / 8)
+
+// frame types, host to board
+#define CAG_PROTO_PING			0x01	// no payload, answered with an ack
+#define CAG_PROTO_UPLOAD		0x10	// grid payload, replaces the simulator grid
+#define CAG_PROTO_DOWNLOAD		0x11	// no payload, answered with a grid frame
+#define CAG_PROTO_STREAM		0x12	// 1 byte: non zero sends a grid frame with every displayed generation
+#define CAG_PROTO_COMMAND		0x20	// simulator command: type, x(2 bytes) y(2 bytes), signed little endian
+// board to host
+#define CAG_PROTO_ACK			0x80	// type acknowledged, status (CAG_PROTO_OK...)
+#define CAG_PROTO_GRID			0x81	// grid payload
+
+// ack status
+#define CAG_PROTO_OK			0
+#define CAG_PROTO_ERR_CRC		1
+#define CAG_PROTO_ERR_LENGTH	2
+#define CAG_PROTO_ERR_TYPE		3
+#define CAG_PROTO_ERR_BUSY		4
+
+// s4375116_lib_cag_proto_feed() results
+#define CAG_PROTO_MORE			0		// frame not complete (or no frame started)
+#define CAG_PROTO_FRAME			1		// a valid frame is in the parser
+#define CAG_PROTO_BAD_CRC		-1
+#define CAG_PROTO_BAD_LENGTH	-2
+
+// frame being received
+struct cagProtoParser {
+	int state;		// next field expected, 0 waiting for the sync byte
+	int type;
+	int length;
+	int count;		// payload bytes received
+	uint16_t crc;	// received crc
+	uint8_t payload[CAG_PROTO_MAX_PAYLOAD];
+};
+typedef struct cagProtoParser CagProtoParser;
+
+uint16_t s4375116_lib_cag_proto_crc16(uint16_t crc, const uint8_t *data, int len);
+void s4375116_lib_cag_proto_reset(CagProtoParser *parser);
+int s4375116_lib_cag_proto_feed(CagProtoParser *parser, uint8_t byte);
+int s4375116_lib_cag_proto_encode(uint8_t *frame, int type, const uint8_t *payload, int len);
+int s4375116_lib_cag_proto_pack_grid(uint8_t *payload, const char *cells, int width, int height, uint32_t generation);
+int s4375116_lib_cag_proto_unpack_grid(const uint8_t *payload, int len, char *cells, int maxCells,
+		int *width, int *height, uint32_t *generation);
+
+#endif
@@ -0,0 +1,419 @@
+ /**
+ **************************************************************
+ * @file mylib/s4375116_CAG_recorder.c
+ * @author Sami Kaab - s4375116
+ * @date 19102026
+ * @brief record game of life frames as run length encoded XOR deltas
+ * Frames go into a RAM ring on the board, or into a file when built with
+ * CAG_RECORDER_FILE (see host/). host/cag_replay turns a recording into a GIF.
+ * The ring always starts with a key frame so a dump of it can be decoded on its own.
+ * Not thread safe, callers keep the recorder to one task or lock around it.
+ * REFERENCE: csse3010_project.pdf
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4375116_lib_cag_recorder_init() - start a new recording of a width by height grid
+ * s4375116_lib_cag_recorder_enable() - pause or resume the recording
+ * s4375116_lib_cag_recorder_frame() - record a frame
+ * s4375116_lib_cag_recorder_size() - number of bytes in the recorded stream
+ * s4375116_lib_cag_recorder_read() - copy part of the recorded stream out of the ring
+ * s4375116_lib_cag_recorder_open() - record into a file instead of the ring (CAG_RECORDER_FILE only)
+ * s4375116_lib_cag_recorder_close() - finish recording into a file (CAG_RECORDER_FILE only)
+ * s4375116_lib_cag_recorder_decode_header() - start decoding a recorded stream
+ * s4375116_lib_cag_recorder_decode() - decode the next frame of a recorded stream
+ ***************************************************************
+ */
+
+#include <string.h>
+#ifdef CAG_RECORDER_FILE
+#include <stdio.h>
+#endif
+
+#include "s4375116_CAG_recorder.h"
+
+#define KEY_HEADER_SIZE		6	// 'K' len generation
+#define DELTA_HEADER_SIZE	3	// 'D' len generationStep
+#define RECORD_MAX_SIZE		(KEY_HEADER_SIZE + CAG_RECORDER_MAX_BYTES + CAG_RECORDER_MAX_BYTES / 128 + 1)
+
+static const uint8_t magic[4] = {'C', 'A', 'G', 'R'};
+
+static int width;
+static int height;
+static int enabled;
+static int frameBytes;						// bytes of a packed frame
+static int sinceKey;						// frames recorded since the last key frame
+static unsigned long lastGeneration;
+static uint8_t prev[CAG_RECORDER_MAX_BYTES];	// last recorded frame, packed
+static uint8_t record[RECORD_MAX_SIZE];		// record being built
+
+/* oldest records are dropped to make room for new ones */
+static uint8_t ring[CAG_RECORDER_RING_SIZE];
+static int ringTail;	// start of the oldest record
+static int ringUsed;	// bytes in the ring
+
+#ifdef CAG_RECORDER_FILE
+static FILE *file;
+#endif
+
+/**
+ * @brief Pack a grid into one bit per cell, cell n is bit (n % 8) of byte (n / 8)
+ *
+ * @param cells width * height cells, non zero is alive
+ * @param bits packed output
+ */
+void pack_frame(const char *cells, uint8_t *bits) {
+
+	int cell;
+
+	memset(bits, 0, frameBytes);
+	for (cell = 0; cell < width * height; cell++) {
+		if (cells[cell]) {
+			bits[cell >> 3] |= 1 << (cell & 7);
+		}
+	}
+}
+
+/**
+ * @brief Run length encode the XOR of two packed frames
+ *
+ * @param curr packed frame to record
+ * @param base packed frame it is a delta against (NULL for a blank frame)
+ * @param out encoded payload
+ * @return int payload length
+ */
+int encode_delta(const uint8_t *curr, const uint8_t *base, uint8_t *out) {
+
+	int len = 0;
+	int i = 0;
+	int run;
+	int literalTag = -1;	// index of the tag of the literal run being built
+
+	while (i < frameBytes) {
+
+		// count unchanged bytes
+		for (run = 0; i + run < frameBytes && run < 128; run++) {
+			if ((curr[i + run] ^ (base ? base[i + run] : 0)) != 0) {
+				break;
+			}
+		}
+
+		// a lone unchanged byte is cheaper inside a literal run
+		if (run > 1 || (run == 1 && literalTag < 0)) {
+			out[len++] = run - 1;
+			literalTag = -1;
+			i += run;
+			continue;
+		}
+
+		if (literalTag < 0 || out[literalTag] == 0xFF) {
+			literalTag = len++;
+			out[literalTag] = 0x7F;
+		}
+		out[literalTag]++;
+		out[len++] = curr[i] ^ (base ? base[i] : 0);
+		i++;
+	}
+	return len;
+}
+
+/**
+ * @brief Apply a run length encoded XOR payload to a packed frame
+ *
+ * @param bits packed frame, updated in place
+ * @param size bytes in the packed frame
+ * @param payload encoded payload
+ * @param len payload length
+ * @return int 0, or -1 if the payload is corrupt
+ */
+int apply_delta(uint8_t *bits, int size, const uint8_t *payload, int len) {
+
+	int pos = 0;
+	int i = 0;
+	int count;
+
+	while (i < len) {
+		if (payload[i] < 0x80) {
+			pos += payload[i++] + 1;
+		} else {
+			count = payload[i++] - 0x7F;
+			if (i + count > len || pos + count > size) {
+				return -1;
+			}
+			while (count--) {
+				bits[pos++] ^= payload[i++];
+			}
+		}
+	}
+	return (pos == size) ? 0 : -1;
+}
+
+/**
+ * @brief Get the size of the record starting at an index of the ring
+ *
+ * @param index ring index of the record type
+ * @return int record size in bytes
+ */
+int ring_record_size(int index) {
+
+	int header = (ring[index] == CAG_RECORDER_KEY) ? KEY_HEADER_SIZE : DELTA_HEADER_SIZE;
+
+	return header + ring[(index + 1) % CAG_RECORDER_RING_SIZE];
+}
+
+/**
+ * @brief Drop the oldest record from the ring
+ *
+ */
+void ring_evict(void) {
+
+	int size = ring_record_size(ringTail);
+
+	ringTail = (ringTail + size) % CAG_RECORDER_RING_SIZE;
+	ringUsed -= size;
+}
+
+/**
+ * @brief Store a record, dropping old records until it fits and the ring starts with a key frame
+ *
+ * @param data record
+ * @param len record length
+ * @return int 0, or -1 if a delta frame would be left without its key frame
+ */
+int record_store(const uint8_t *data, int len) {
+
+	int head;
+
+#ifdef CAG_RECORDER_FILE
+	if (file != NULL) {
+		return (fwrite(data, 1, len, file) == (size_t) len) ? 0 : -1;
+	}
+#endif
+
+	while (CAG_RECORDER_RING_SIZE - ringUsed < len) {
+		ring_evict();
+	}
+	while (ringUsed > 0 && ring[ringTail] != CAG_RECORDER_KEY) {
+		ring_evict();
+	}
+	if (ringUsed == 0 && data[0] != CAG_RECORDER_KEY) {
+		return -1;
+	}
+
+	head = (ringTail + ringUsed) % CAG_RECORDER_RING_SIZE;
+	for (int i = 0; i < len; i++) {
+		ring[(head + i) % CAG_RECORDER_RING_SIZE] = data[i];
+	}
+	ringUsed += len;
+	return 0;
+}
+
+/**
+ * @brief Build a key frame record from the packed frame in prev
+ *
+ * @param generation generation of the frame
+ * @return int record length
+ */
+int build_key(unsigned long generation) {
+
+	int len = encode_delta(prev, NULL, &record[KEY_HEADER_SIZE]);
+
+	record[0] = CAG_RECORDER_KEY;
+	record[1] = len;
+	for (int i = 0; i < 4; i++) {
+		record[2 + i] = (generation >> (8 * i)) & 0xFF;
+	}
+	return KEY_HEADER_SIZE + len;
+}
+
+/*
+ * Start a new recording of a width by height grid, the ring is emptied
+ */
+int s4375116_lib_cag_recorder_init(int gridWidth, int gridHeight) {
+
+	if (gridWidth <= 0 || gridHeight <= 0 || gridWidth > 255 || gridHeight > 255 ||
+			gridWidth * gridHeight > CAG_RECORDER_MAX_CELLS) {
+		return -1;
+	}
+
+	width = gridWidth;
+	height = gridHeight;
+	frameBytes = (width * height + 7) / 8;
+	ringTail = 0;
+	ringUsed = 0;
+	sinceKey = CAG_RECORDER_KEY_INTERVAL;	// first frame is a key frame
+	enabled = 1;
+	return 0;
+}
+
+/*
+ * Pause (0) or resume (1) the recording, the next frame after a pause is a key frame
+ */
+void s4375116_lib_cag_recorder_enable(int enable) {
+
+	if (enable && !enabled) {
+		sinceKey = CAG_RECORDER_KEY_INTERVAL;
+	}
+	enabled = (width > 0) && enable;
+}
+
+/*
+ * Record a frame of width * height cells, returns the bytes recorded
+ */
+int s4375116_lib_cag_recorder_frame(const char *cells, unsigned long generation) {
+
+	uint8_t curr[CAG_RECORDER_MAX_BYTES];
+	unsigned long step = generation - lastGeneration;
+	int len;
+
+	if (!enabled) {
+		return 0;
+	}
+
+	pack_frame(cells, curr);
+
+	if (sinceKey >= CAG_RECORDER_KEY_INTERVAL || generation < lastGeneration || step > 0xFF) {
+		memcpy(prev, curr, frameBytes);
+		len = build_key(generation);
+		sinceKey = 0;
+	} else {
+		len = encode_delta(curr, prev, &record[DELTA_HEADER_SIZE]);
+		record[0] = CAG_RECORDER_DELTA;
+		record[1] = len;
+		record[2] = step;
+		len += DELTA_HEADER_SIZE;
+		memcpy(prev, curr, frameBytes);
+		sinceKey++;
+	}
+	lastGeneration = generation;
+
+	if (record_store(record, len) < 0) {
+		// the ring dropped the key frame this delta depends on, start again from a key frame
+		len = build_key(generation);
+		sinceKey = 0;
+		record_store(record, len);
+	}
+	return len;
+}
+
+/*
+ * Number of bytes in the recorded stream, including the stream header
+ */
+int s4375116_lib_cag_recorder_size(void) {
+
+	return (width > 0) ? CAG_RECORDER_HEADER_SIZE + ringUsed : 0;
+}
+
+/*
+ * Copy up to len bytes of the recorded stream starting at offset, returns the bytes copied
+ */
+int s4375116_lib_cag_recorder_read(uint8_t *buf, int offset, int len) {
+
+	int size = s4375116_lib_cag_recorder_size();
+	int count = 0;
+
+	for (; count < len && offset < size; count++, offset++) {
+		if (offset < 4) {
+			buf[count] = magic[offset];
+		} else if (offset == 4) {
+			buf[count] = width;
+		} else if (offset == 5) {
+			buf[count] = height;
+		} else {
+			buf[count] = ring[(ringTail + offset - CAG_RECORDER_HEADER_SIZE) % CAG_RECORDER_RING_SIZE];
+		}
+	}
+	return count;
+}
+
+#ifdef CAG_RECORDER_FILE
+/*
+ * Record into a file instead of the ring until s4375116_lib_cag_recorder_close()
+ */
+int s4375116_lib_cag_recorder_open(const char *path, int gridWidth, int gridHeight) {
+
+	uint8_t header[CAG_RECORDER_HEADER_SIZE];
+
+	if (s4375116_lib_cag_recorder_init(gridWidth, gridHeight) < 0) {
+		return -1;
+	}
+	file = fopen(path, "wb");
+	if (file == NULL) {
+		return -1;
+	}
+	s4375116_lib_cag_recorder_read(header, 0, sizeof(header));
+	fwrite(header, 1, sizeof(header), file);
+	return 0;
+}
+
+/*
+ * Finish recording into the file
+ */
+void s4375116_lib_cag_recorder_close(void) {
+
+	if (file != NULL) {
+		fclose(file);
+		file = NULL;
+	}
+	enabled = 0;
+}
+#endif
+
+/*
+ * Read the stream header, returns the bytes used or -1 if it is not a recording
+ */
+int s4375116_lib_cag_recorder_decode_header(CagRecorderDecoder *dec, const uint8_t *data, int len) {
+
+	if (len < CAG_RECORDER_HEADER_SIZE || memcmp(data, magic, sizeof(magic)) != 0 ||
+			data[4] * data[5] == 0 || data[4] * data[5] > CAG_RECORDER_MAX_CELLS) {
+		return -1;
+	}
+
+	memset(dec, 0, sizeof(*dec));
+	dec->width = data[4];
+	dec->height = data[5];
+	return CAG_RECORDER_HEADER_SIZE;
+}
+
+/*
+ * Decode the record at data into cells (width * height, 0 or 1).
+ * Returns the bytes used, 0 at the end of the data or -1 if it is corrupt.
+ * cells are only written once a key frame has been seen (dec->keyed)
+ */
+int s4375116_lib_cag_recorder_decode(CagRecorderDecoder *dec, const uint8_t *data, int len, char *cells) {
+
+	int size = (dec->width * dec->height + 7) / 8;
+	int header;
+	int payload;
+
+	if (len < 2) {
+		return 0;
+	}
+
+	header = (data[0] == CAG_RECORDER_KEY) ? KEY_HEADER_SIZE : DELTA_HEADER_SIZE;
+	payload = data[1];
+	if (data[0] != CAG_RECORDER_KEY && data[0] != CAG_RECORDER_DELTA) {
+		return -1;
+	}
+	if (len < header + payload) {
+		return 0;
+	}
+
+	if (data[0] == CAG_RECORDER_KEY) {
+		memset(dec->bits, 0, size);
+		dec->generation = data[2] | (data[3] << 8) | ((unsigned long) data[4] << 16) | ((unsigned long) data[5] << 24);
+		dec->keyed = 1;
+	} else {
+		dec->generation += data[2];
+	}
+
+	if (apply_delta(dec->bits, size, &data[header], payload) < 0) {
+		return -1;
+	}
+
+	if (dec->keyed) {
+		for (int cell = 0; cell < dec->width * dec->height; cell++) {
+			cells[cell] = (dec->bits[cell >> 3] >> (cell & 7)) & 1;
+		}
+	}
+	return header + payload;
+}
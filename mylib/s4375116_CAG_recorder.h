@@ -0,0 +1,70 @@
+ /**
+ **************************************************************
+ * @file mylib/s4375116_CAG_recorder.h
+ * @author Sami Kaab - s4375116
+ * @date 19102026
+ * @brief record game of life frames as run length encoded XOR deltas
+ * Frames go into a RAM ring on the board, or into a file when built with
+ * CAG_RECORDER_FILE (see host/). host/cag_replay turns a recording into a GIF.
+ *
+ * Stream: "CAGR" width height, then one record per frame
+ *  key frame:   'K' len generation(4 bytes, little endian) payload
+ *  delta frame: 'D' len generationStep payload
+ * payload is the packed grid (1 bit per cell, LSB first) XORed with the previous
+ * frame (key frames XOR against a blank grid), run length encoded:
+ *  0x00-0x7F: (tag + 1) zero bytes, 0x80-0xFF: (tag - 0x7F) literal bytes follow
+ * REFERENCE: csse3010_project.pdf
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4375116_lib_cag_recorder_init() - start a new recording of a width by height grid
+ * s4375116_lib_cag_recorder_enable() - pause or resume the recording
+ * s4375116_lib_cag_recorder_frame() - record a frame
+ * s4375116_lib_cag_recorder_size() - number of bytes in the recorded stream
+ * s4375116_lib_cag_recorder_read() - copy part of the recorded stream out of the ring
+ * s4375116_lib_cag_recorder_open() - record into a file instead of the ring (CAG_RECORDER_FILE only)
+ * s4375116_lib_cag_recorder_close() - finish recording into a file (CAG_RECORDER_FILE only)
+ * s4375116_lib_cag_recorder_decode_header() - start decoding a recorded stream
+ * s4375116_lib_cag_recorder_decode() - decode the next frame of a recorded stream
+ ***************************************************************
+ */
+
+#ifndef S4375116_CAG_RECORDER_H
+#define S4375116_CAG_RECORDER_H
+
+#include <stdint.h>
+
+#ifndef CAG_RECORDER_RING_SIZE
+#define CAG_RECORDER_RING_SIZE		4096	// bytes of RAM holding the most recent records
+#endif
+#define CAG_RECORDER_MAX_CELLS		1024	// largest grid that can be recorded
+#define CAG_RECORDER_MAX_BYTES		(CAG_RECORDER_MAX_CELLS / 8)
+#define CAG_RECORDER_KEY_INTERVAL	64		// frames between key frames
+#define CAG_RECORDER_HEADER_SIZE	6		// "CAGR" width height
+
+#define CAG_RECORDER_KEY	'K'
+#define CAG_RECORDER_DELTA	'D'
+
+// state needed to decode a recorded stream
+struct cagRecorderDecoder {
+	int width;
+	int height;
+	int keyed;					// a key frame has been decoded, cells are valid
+	unsigned long generation;	// generation of the last decoded frame
+	uint8_t bits[CAG_RECORDER_MAX_BYTES];	// last decoded frame, packed
+};
+typedef struct cagRecorderDecoder CagRecorderDecoder;
+
+int s4375116_lib_cag_recorder_init(int width, int height);
+void s4375116_lib_cag_recorder_enable(int enable);
+int s4375116_lib_cag_recorder_frame(const char *cells, unsigned long generation);
+int s4375116_lib_cag_recorder_size(void);
+int s4375116_lib_cag_recorder_read(uint8_t *buf, int offset, int len);
+#ifdef CAG_RECORDER_FILE
+int s4375116_lib_cag_recorder_open(const char *path, int width, int height);
+void s4375116_lib_cag_recorder_close(void);
+#endif
+int s4375116_lib_cag_recorder_decode_header(CagRecorderDecoder *dec, const uint8_t *data, int len);
+int s4375116_lib_cag_recorder_decode(CagRecorderDecoder *dec, const uint8_t *data, int len, char *cells);
+
+#endif
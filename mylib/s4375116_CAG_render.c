@@ -0,0 +1,53 @@
+ /**
+ **************************************************************
+ * @file mylib/s4375116_CAG_render.c
+ * @author Sami Kaab - s4375116 
+ * @date 19102026
+ * @brief functions to draw the game of life grid into the OLED frame buffer
+ * Draws into s4375116_oled_fb so it also builds on the host (see host/)
+ * REFERENCE: csse3010_project.pdf
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4375116_lib_cag_render_grid() - draw a grid of cells into the OLED frame buffer
+ ***************************************************************
+ */
+
+#include <stdint.h>
+
+#include "s4375116_oled_fb.h"
+#include "s4375116_CAG_render.h"
+
+/**
+ * @brief Draw a grid of cells into the OLED frame buffer, each cell is cellSize by cellSize pixels.
+ * The grid is built one page column byte at a time, so only bytes that change are sent on the next flush.
+ * 
+ * @param cells row major array of width * height cells, non zero cells are alive
+ * @param width number of cells in a row
+ * @param height number of rows
+ * @param cellSize size of a cell in pixels
+ */
+void s4375116_lib_cag_render_grid(const char *cells, int width, int height, int cellSize) {
+
+	int rows = height * cellSize;	// pixel rows covered by the grid
+	int pages = (rows + 7) / 8;
+	uint8_t bits, mask;
+	int y;
+
+	for (int page = 0; page < pages; page++) {
+
+		// only touch the pixel rows of this page that belong to the grid
+		mask = (rows - page * 8 >= 8) ? 0xFF : (1 << (rows - page * 8)) - 1;
+
+		for (int x = 0; x < width * cellSize; x++) {
+			bits = 0;
+			for (int b = 0; b < 8; b++) {
+				y = (page * 8 + b) / cellSize;
+				if (y < height && cells[y * width + x / cellSize]) {
+					bits |= 1 << b;
+				}
+			}
+			s4375116_lib_oled_fb_put(x, page, bits, mask);
+		}
+	}
+}
@@ -0,0 +1,21 @@
+ /**
+ **************************************************************
+ * @file mylib/s4375116_CAG_render.h
+ * @author Sami Kaab - s4375116 
+ * @date 19102026
+ * @brief functions to draw the game of life grid into the OLED frame buffer
+ * Draws into s4375116_oled_fb so it also builds on the host (see host/)
+ * REFERENCE: csse3010_project.pdf
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4375116_lib_cag_render_grid() - draw a grid of cells into the OLED frame buffer
+ ***************************************************************
+ */
+
+#ifndef S4375116_CAG_RENDER_H
+#define S4375116_CAG_RENDER_H
+
+void s4375116_lib_cag_render_grid(const char *cells, int width, int height, int cellSize);
+
+#endif
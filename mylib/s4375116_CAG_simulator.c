@@ -9,9 +9,14 @@
  * EXTERNAL FUNCTIONS
  ***************************************************************
  * s4375116_tsk_cag_simulator_init() - create the game of life simulator controlling task
+ * s4375116_cag_simulator_command() - send a command to the simulator task
+ * s4375116_cag_simulator_load() - replace the grid with a packed grid
+ * s4375116_cag_simulator_step() - step the grid one generation in place (bench command)
  ***************************************************************
  */
 
+#include <string.h>
+
 #include "board.h"
 #include "processor_hal.h"
 #include "debug_log.h"
@@ -31,15 +36,28 @@
 #include "s4375116_CAG_grid.h"
 #include "s4375116_CAG_joystick.h"
 #include "s4375116_CAG_mnemonic.h"
+#include "s4375116_console.h"
+#include "s4375116_latency.h"
+#include "s4375116_uart_tx.h"
+#include "s4375116_trace.h"
+#include "s4375116_CAG_proto.h"
+#include "s4375116_CAG_link.h"
 
 static uint8_t stop = 1;
-static uint8_t updateTime = 1;
+static TickType_t period = pdMS_TO_TICKS(CAGSIMULATOR_DEFAULT_PERIOD);	// ticks between generations
+static TickType_t nextGenerationTick;	// when the next generation is due while running
+static unsigned long generation = 0; // generations since the grid was cleared
+static uint32_t pendingInputStamp = LATENCY_NONE;	// key applied to the grid but not sent to the display yet
+static uint32_t pendingAppliedStamp;
+static uint8_t loadGrid[CAG_PROTO_GRID_SIZE(GRID_WIDTH, GRID_HEIGHT)];	// grid payload waiting for CA_CMD_LOAD
+static SemaphoreHandle_t loadFree = NULL;	// taken while loadGrid holds a grid
 
 /**
  * @brief Clear the grid by replacing all its values with zeroes
  * 
  */
 void clear_grid(void){                                                           
+    generation = 0;
     for(int y = 0; y < GRID_HEIGHT; y++) {                                           
         for(int x = 0; x < GRID_WIDTH; x++) {                                        
             GRID[y][x] = 0;                                                     
@@ -68,7 +86,7 @@ void clear_pattern(void){
 void printGrid(int grid[GRID_HEIGHT][GRID_WIDTH], int showNums){                                           
     int alive;     
     for(int x = 0; x < GRID_WIDTH; x++) {                                       
-        debug_log("___");                                                          
+        s4375116_uart_tx_printf("___");                                                          
     }                           
 
     for(int y = 0; y < GRID_HEIGHT; y++) {                                           
@@ -76,20 +94,20 @@ void printGrid(int grid[GRID_HEIGHT][GRID_WIDTH], int showNums){
             alive = grid[y][x];                             
             if (!showNums) {
                 if(alive) {                                                         
-                    debug_log(" # ");                                                  
+                    s4375116_uart_tx_printf(" # ");                                                  
                 } else {                                                            
-                    debug_log("   ");                                                  
+                    s4375116_uart_tx_printf("   ");                                                  
                 }
             } else {
-                debug_log(" %d ",alive);
+                s4375116_uart_tx_printf(" %d ",alive);
             }         
         }                                                                
-        debug_log("|\n\r");                                                           
+        s4375116_uart_tx_printf("|\n\r");                                                           
     }   
     for(int x = 0; x < GRID_WIDTH; x++) {                                       
-        debug_log("___");                                                          
+        s4375116_uart_tx_printf("___");                                                          
     }      
-    debug_log("\n\r");                                                                           
+    s4375116_uart_tx_printf("\n\r");                                                                           
 }                                                                               
 
 /**
@@ -122,11 +140,20 @@ void update_pattern(void){
 
 /**
  * @brief Use the calculated pattern of the current grid to compute the next state of the grid
+ * and write the new state straight into the display frame
  * 
+ * @param frame frame sent to the CAG display, may be NULL if no frame was free
  */
-void update_GRID(void) {                                                        
+void update_GRID(CagDisplayTextMsg *frame) {                                                        
     int alive = 0;   
     int sum = 0;           
+    generation++;
+    if (frame != NULL) {
+        frame->generation = generation;
+        frame->inputStamp = pendingInputStamp;
+        frame->stageStamp = pendingAppliedStamp;
+        frame->population = 0;
+    }
     //iterate through every cell                                                
     for(int y = 0; y < GRID_HEIGHT; y++) {                                           
         for(int x = 0; x < GRID_WIDTH; x++) {                                        
@@ -140,29 +167,35 @@ void update_GRID(void) {
                 //...comes to life               
                 GRID[y][x] = 1;                                                 
             } // else live cells lives and dead cells stay dead                                              
+            if (frame != NULL) {
+                frame->grid[y][x] = GRID[y][x];
+                frame->population += GRID[y][x];
+            }
         }                                                                       
     }                                                                           
 }                                                                               
 
 /**
- * @brief Copy the game of life grid to the specified message struct.
+ * @brief Copy the game of life grid into a free display frame and publish it to the CAG display.
  * 
- * @param message Struct sent to the CAG display
  */
 void send_grid_to_display(void) {
-    for(int y = 0; y < GRID_HEIGHT; y++) {                                           
-        for(int x = 0; x < GRID_WIDTH; x++) {                                        
-            if (GRID[y][x] == 1) {            
-                sendGridMsg.grid[y][x] = 1;                                                 
-            } else {                          
-                sendGridMsg.grid[y][x] = 0;                                                 
-            }                                                                   
-        }                                                                       
-    }
-    //send grid to display
-    if (CAGDisplayMessageQueue != NULL) {	// Check if queue exists 
-        xQueueSendToFront(CAGDisplayMessageQueue, ( void * ) &sendGridMsg, ( portTickType ) 10 );
+
+    CagDisplayTextMsg *frame = s4375116_cag_display_frame_acquire();
+
+    if (frame != NULL) {	// Check a frame was free
+        frame->generation = generation;
+        frame->population = 0;
+        for(int y = 0; y < GRID_HEIGHT; y++) {                                           
+            for(int x = 0; x < GRID_WIDTH; x++) {                                        
+                frame->grid[y][x] = (GRID[y][x] == 1);
+                frame->population += frame->grid[y][x];
+            }                                                                       
+        }
+        //send grid to display
+        s4375116_cag_display_frame_publish(frame);
     }
+    pendingInputStamp = LATENCY_NONE;
 }
 
 void add_life(int x, int y,int *grid) {                                                     
@@ -185,153 +218,216 @@ void add_life(int x, int y,int *grid) {
  */
 void process_grid_message(void) {
     if(rcvdCaMessage.x < GRID_WIDTH && rcvdCaMessage.x >= 0 && rcvdCaMessage.y < GRID_HEIGHT && rcvdCaMessage.y >= 0) {
-        if (rcvdCaMessage.type == 0x10) {
+        if (rcvdCaMessage.type == CA_CMD_KILL) {
             GRID[rcvdCaMessage.y][rcvdCaMessage.x] = 0;
-            debug_log("Kill cell at (%d, %d)\n\r",rcvdCaMessage.x,rcvdCaMessage.y);
-        } else if (rcvdCaMessage.type == 0x11) {
+            TRACE_LOG("Kill cell at (%d, %d)\n\r",rcvdCaMessage.x,rcvdCaMessage.y);
+        } else if (rcvdCaMessage.type == CA_CMD_SPAWN) {
             GRID[rcvdCaMessage.y][rcvdCaMessage.x] = 1;
-            debug_log("Spawn cell at (%d, %d)\n\r",rcvdCaMessage.x,rcvdCaMessage.y);
+            TRACE_LOG("Spawn cell at (%d, %d)\n\r",rcvdCaMessage.x,rcvdCaMessage.y);
         } else if (rcvdCaMessage.type == 0x20) {
             add_life(rcvdCaMessage.x,rcvdCaMessage.y,(int *)BLOCK);
-            debug_log("Spawn Block at (%d, %d)\n\r",rcvdCaMessage.x,rcvdCaMessage.y);
+            TRACE_LOG("Spawn Block at (%d, %d)\n\r",rcvdCaMessage.x,rcvdCaMessage.y);
         } else if (rcvdCaMessage.type == 0x21) {
             add_life(rcvdCaMessage.x,rcvdCaMessage.y,(int *)BEEHIVE);
-            debug_log("Spawn Beehive at (%d, %d)\n\r",rcvdCaMessage.x,rcvdCaMessage.y);
+            TRACE_LOG("Spawn Beehive at (%d, %d)\n\r",rcvdCaMessage.x,rcvdCaMessage.y);
         } else if (rcvdCaMessage.type == 0x22) {
             add_life(rcvdCaMessage.x,rcvdCaMessage.y,(int *)LOAF);
-            debug_log("Spawn Loaf at (%d, %d)\n\r",rcvdCaMessage.x,rcvdCaMessage.y);
+            TRACE_LOG("Spawn Loaf at (%d, %d)\n\r",rcvdCaMessage.x,rcvdCaMessage.y);
         } else if (rcvdCaMessage.type == 0x30) {
             add_life(rcvdCaMessage.x,rcvdCaMessage.y,(int *)BLINKER);
-            debug_log("Spawn Blinker at (%d, %d)\n\r",rcvdCaMessage.x,rcvdCaMessage.y);
+            TRACE_LOG("Spawn Blinker at (%d, %d)\n\r",rcvdCaMessage.x,rcvdCaMessage.y);
         } else if (rcvdCaMessage.type == 0x31) {
             add_life(rcvdCaMessage.x,rcvdCaMessage.y,(int *)TOAD);
-            debug_log("Spawn Toad at (%d, %d)\n\r",rcvdCaMessage.x,rcvdCaMessage.y);
+            TRACE_LOG("Spawn Toad at (%d, %d)\n\r",rcvdCaMessage.x,rcvdCaMessage.y);
         } else if (rcvdCaMessage.type == 0x32) {
             add_life(rcvdCaMessage.x,rcvdCaMessage.y,(int *)BEACON);
-            debug_log("Spawn Beacon at (%d, %d)\n\r",rcvdCaMessage.x,rcvdCaMessage.y);
+            TRACE_LOG("Spawn Beacon at (%d, %d)\n\r",rcvdCaMessage.x,rcvdCaMessage.y);
         }  else if (rcvdCaMessage.type == 0x40) {
             add_life(rcvdCaMessage.x,rcvdCaMessage.y,(int *)GLIDER);
-            debug_log("Spawn Glider at (%d, %d)\n\r",rcvdCaMessage.x,rcvdCaMessage.y);
+            TRACE_LOG("Spawn Glider at (%d, %d)\n\r",rcvdCaMessage.x,rcvdCaMessage.y);
         }  else {
-            debug_log("Invalid life form\r\n");
+            TRACE_LOG("Invalid life form\r\n");
         }
     } else {
-        debug_log("Invalid position\r\n");
+        TRACE_LOG("Invalid position\r\n");
     }
 }
 
+void print_binary(int num,int nbbits) {
+  s4375116_uart_tx_printf("\n\r");
+  for(int i = nbbits-1; i >= 0; i--) {
+    if((num >> i) & 0x1){
+      s4375116_uart_tx_printf("1");
+    } else {
+      s4375116_uart_tx_printf("0");
+    }
+
+  }
+  s4375116_uart_tx_printf("\n\r");
+}
+
 /**
- * @brief Reads from the cag simulator message queue and processes the message
+ * @brief Replace the grid with the uploaded grid payload
  * 
- * @param rcvdCaMessage the message struct
  */
-void read_queue(void){
-    // receive message from CAG_grid or ....to add later!
-    if (CAGSimulatorMessageQueue != NULL) {	// Check if queue exists
+void load_grid(void) {
+
+    const uint8_t *bits = &loadGrid[CAG_PROTO_GRID_HEADER];
+    int cell;
 
-        // Check for item received - block atmost for 10 ticks
-        if (xQueueReceive( CAGSimulatorMessageQueue, &rcvdCaMessage, 10 )) {
-            process_grid_message();
+    generation = loadGrid[2] | (loadGrid[3] << 8) | (loadGrid[4] << 16) | ((uint32_t) loadGrid[5] << 24);
+    for(int y = 0; y < GRID_HEIGHT; y++) {
+        for(int x = 0; x < GRID_WIDTH; x++) {
+            cell = y * GRID_WIDTH + x;
+            GRID[y][x] = (bits[cell >> 3] >> (cell & 7)) & 0x01;
         }
-    } 
+    }
+    xSemaphoreGive(loadFree);
 }
 
+/**
+ * @brief Send the grid to the host as a grid frame
+ * 
+ */
+void download_grid(void) {
 
-void print_binary(int num,int nbbits) {
-  debug_log("\n\r");
-  for(int i = nbbits-1; i >= 0; i--) {
-    if((num >> i) & 0x1){
-      debug_log("1");
-    } else {
-      debug_log("0");
-    }
+    uint8_t payload[CAG_PROTO_GRID_SIZE(GRID_WIDTH, GRID_HEIGHT)] = {GRID_WIDTH, GRID_HEIGHT};
+    uint8_t *bits = &payload[CAG_PROTO_GRID_HEADER];
+    int cell;
 
-  }
-  debug_log("\n\r");
+    for (int i = 0; i < 4; i++) {
+        payload[2 + i] = (generation >> (8 * i)) & 0xFF;
+    }
+    for(int y = 0; y < GRID_HEIGHT; y++) {
+        for(int x = 0; x < GRID_WIDTH; x++) {
+            cell = y * GRID_WIDTH + x;
+            if (GRID[y][x]) {
+                bits[cell >> 3] |= 1 << (cell & 7);
+            }
+        }
+    }
+    s4375116_cag_link_send(CAG_PROTO_GRID, payload, sizeof(payload), CAG_LINK_REPLY_WAIT);
 }
 
 /**
- * @brief handle event bits by executing the correct function based on which bit is set
+ * @brief Carry out a command received from the simulator queue
  * 
- * @param uxBits pointer to an event bit
- * @param rcvdCaMessage the message struct
  */
-void handle_event_bits (void) {
-    uxBits = xEventGroupWaitBits(gridctrlEventGroup, GRID_CTRL_EVENT, pdTRUE, pdFALSE, 10);
-    // Check if clear grid Event flag is set
-    if ((uxBits & EVT_CLR_GRID) != 0) {
+void process_command(void) {
+
+    uint32_t appliedStamp = s4375116_latency_now();
+
+    s4375116_latency_record(LATENCY_INPUT_APPLIED, rcvdCaMessage.inputStamp, appliedStamp);
+    // an edit is timed until the frame showing it reaches the screen
+    pendingInputStamp = rcvdCaMessage.inputStamp;
+    pendingAppliedStamp = appliedStamp;
+
+    switch (rcvdCaMessage.type) {
+    case CA_CMD_START:
+    case CA_CMD_STOP:
+    case CA_CMD_START_STOP:
+        if (rcvdCaMessage.type == CA_CMD_START_STOP) {
+            stop = !stop;
+        } else {
+            stop = (rcvdCaMessage.type == CA_CMD_STOP);
+        }
+        // a full period before the first generation, as when started from the loop
+        nextGenerationTick = xTaskGetTickCount() + period;
+        TRACE_LOG("Simulation %s\r\n", stop ? "stopped" : "running");
+        break;
+    case CA_CMD_PERIOD:
+        // keep the time of the last generation, the next one moves with the new period
+        nextGenerationTick = nextGenerationTick - period + pdMS_TO_TICKS(rcvdCaMessage.x);
+        period = pdMS_TO_TICKS(rcvdCaMessage.x);
+        TRACE_LOG("The simulation updates every %d ms\n\r", rcvdCaMessage.x);
+        break;
+    case CA_CMD_CLEAR:
         clear_grid(); 
         send_grid_to_display();
-        uxBits = xEventGroupClearBits(gridctrlEventGroup, EVT_CLR_GRID);		//Clear LED ON event flat.
-        debug_log("Grid Cleared\r\n");
- }
-    // Check if start stop grid Event flag is set
-    if ((uxBits & EVT_START_STOP) != 0) {
-        stop = !stop;
-        uxBits = xEventGroupClearBits(gridctrlEventGroup, EVT_START_STOP);		//Clear LED ON event flat.
-        debug_log("Simulation %s\r\n", stop ? "stopped" : "running");
-        }
-    // Check if select cell grid Event flag is set
-    if ((uxBits & EVT_SLCT_CELL) != 0) {
-        read_queue();
+        TRACE_LOG("Grid Cleared\r\n");
+        break;
+    case CA_CMD_LOAD:
+        load_grid();
         send_grid_to_display();
-        uxBits = xEventGroupClearBits(gridctrlEventGroup, EVT_SLCT_CELL);		//Clear LED ON event flat.
-    }
-    // Check if unselect cell grid Event flag is set
-    if ((uxBits & EVT_USLCT_CELL) != 0) {
-        read_queue(); //read message from cag grid
+        TRACE_LOG("Grid loaded, generation %lu\r\n", generation);
+        break;
+    case CA_CMD_DOWNLOAD:
+        download_grid();
+        break;
+    default: // cell edit or life form
+        process_grid_message();
         send_grid_to_display();
-        uxBits = xEventGroupClearBits(gridctrlEventGroup, EVT_USLCT_CELL);		//Clear LED ON event flat.
+        break;
     }
+    pendingInputStamp = LATENCY_NONE;
+}
 
-    uxBits = xEventGroupWaitBits(joystickctrlEventGroup, JOYSTICK_CTRL_EVENT, pdTRUE, pdFALSE, 10);
-    
-    // Check if start joystick Event flag is set
-    if ((uxBits & EVT_START) != 0) {
-        stop = 0;
-        uxBits = xEventGroupClearBits(joystickctrlEventGroup, EVT_START);		//Clear LED ON event flat.
-        debug_log("Simulation running\r\n");
-    }
-    // Check if stop joystick Event flag is set
-    if ((uxBits & EVT_STOP) != 0) {
-        stop = 1; // stop becomes true
-        uxBits = xEventGroupClearBits(joystickctrlEventGroup, EVT_STOP);		//Clear LED ON event flat.
-        debug_log("Simulation stopped\r\n");
-    }
-    // Check if set update time to 1 joystick Event flag is set
-    if ((uxBits & EVT_UPDATE_TIME_1) != 0) {
-        updateTime = 1;
-        uxBits = xEventGroupClearBits(joystickctrlEventGroup, EVT_UPDATE_TIME_1);		//Clear LED ON event flat.
-        debug_log("The simulation updates every second\n\r");
+/**
+ * @brief Send a command to the simulator task. A clear while the simulator task is deleted goes straight to the display.
+ * 
+ * @param type CA_CMD_* or life form type
+ * @param x x coordinate or argument of the command
+ * @param y y coordinate
+ */
+void s4375116_cag_simulator_command(int type, int x, int y) {
+
+    caMessage_t command;
+
+    if (type == CA_CMD_CLEAR && xSimulatorCagTaskHandle == NULL) {
+        uxBits = xEventGroupSetBits(gridctrlEventGroup, EVT_CLR_GRID);
+        return;
     }
-    // Check if set update time to 2 joystick Event flag is set
-    if ((uxBits & EVT_UPDATE_TIME_2) != 0) {
-        updateTime = 2;
-        uxBits = xEventGroupClearBits(joystickctrlEventGroup, EVT_UPDATE_TIME_2);		//Clear LED ON event flat.
-        debug_log("The simulation updates every 2 seconds\n\r");
+
+    command.type = type;
+    command.x = x;
+    command.y = y;
+    command.inputStamp = s4375116_console_input_stamp();
+    if (CAGSimulatorMessageQueue != NULL) {	// Check if queue exists 
+        xQueueSendToBack(CAGSimulatorMessageQueue, ( void * ) &command, ( portTickType ) 10 );
     }
-    // Check if set update time to 2 joystick Event flag is set
-    if ((uxBits & EVT_UPDATE_TIME_5) != 0) {
-        updateTime = 5;
-        uxBits = xEventGroupClearBits(joystickctrlEventGroup, EVT_UPDATE_TIME_5);		//Clear LED ON event flat.
-        debug_log("The simulation updates every 5 seconds\n\r");
+}
+
+/**
+ * @brief Replace the grid with a packed grid (s4375116_CAG_proto grid payload of GRID_WIDTH by GRID_HEIGHT),
+ * applied by the simulator task between generations.
+ * 
+ * @param payload grid payload, copied
+ * @param len payload length
+ * @return int 0, or -1 if the simulator task is deleted or still busy with the previous grid
+ */
+int s4375116_cag_simulator_load(const uint8_t *payload, int len) {
+
+    caMessage_t command;
+
+    if (xSimulatorCagTaskHandle == NULL || loadFree == NULL || len != sizeof(loadGrid) ||
+            xSemaphoreTake(loadFree, 0) != pdTRUE) {
+        return -1;
     }
-    // Check if set update time to 10 joystick Event flag is set
-    if ((uxBits & EVT_UPDATE_TIME_10) != 0) {
-        updateTime = 10;
-        uxBits = xEventGroupClearBits(joystickctrlEventGroup, EVT_UPDATE_TIME_10);		//Clear LED ON event flat.
-        debug_log("The simulation updates every 10 second\n\r");
+    memcpy(loadGrid, payload, sizeof(loadGrid));
+
+    command.type = CA_CMD_LOAD;
+    command.x = 0;
+    command.y = 0;
+    command.inputStamp = s4375116_console_input_stamp();
+    if (xQueueSendToBack(CAGSimulatorMessageQueue, ( void * ) &command, ( portTickType ) 10 ) != pdTRUE) {
+        xSemaphoreGive(loadFree);	// never applied, the grid can be sent again
+        return -1;
     }
+    return 0;
+}
 
+/**
+ * @brief Step the grid one generation without sending it to the display or counting the generation.
+ * Used by the bench command, which keeps every task off the grid while it runs and restores it.
+ * 
+ */
+void s4375116_cag_simulator_step(void) {
 
-    if (drawLifeSemaphore != NULL) {	// Check if semaphore exists
-        /* See if we can obtain the PB semaphore. If the semaphore is not available
-        wait 10 ticks to see if it becomes free. */
-        if( xSemaphoreTake( drawLifeSemaphore, 10 ) == pdTRUE ) {
-            read_queue();
-            send_grid_to_display();
-        }
-    }
+    unsigned long savedGeneration = generation;
+
+    update_pattern();
+    update_GRID(NULL);
+    generation = savedGeneration;
 }
 
 /**
@@ -347,10 +443,6 @@ void s4375116TaskCAGSimulator( void ) {
 	portENABLE_INTERRUPTS();	//Enable interrupts
 	
 	
-	//queue to receive the game of life grid
-	CAGSimulatorMessageQueue = xQueueCreate(5, sizeof(rcvdCaMessage));		// Create queue of length 10 Message items 
-
-
     // Initialise grid and pattern
 	clear_grid();        
 	clear_pattern();   
@@ -365,30 +457,41 @@ void s4375116TaskCAGSimulator( void ) {
     add_life(50,2,(int *)BEACON);
     add_life(2,7,(int *)GLIDER);
 
-    TickType_t currTick = xTaskGetTickCount();
-    TickType_t lastTick = xTaskGetTickCount();
+    TickType_t wait;
+    CagDisplayTextMsg *frame; // frame the next generation is written into
     send_grid_to_display();
     
 
 	for (;;) {
 
-        handle_event_bits();
-        
+        // sleep until the next generation is due, or forever while paused
+        if (stop) {
+            wait = portMAX_DELAY;
+        } else if ((int32_t) (nextGenerationTick - xTaskGetTickCount()) > 0) {
+            wait = nextGenerationTick - xTaskGetTickCount();
+        } else {
+            wait = 0;
+        }
 
+        if (xQueueReceive( CAGSimulatorMessageQueue, &rcvdCaMessage, wait ) == pdTRUE) {
+            process_command();
+            continue;
+        }
 
-        if ((currTick-lastTick) > ((updateTime) * configTICK_RATE_HZ) && !stop) { // check that a the time passed is greater than update time and we're not in paused mode
-            // debug_log("UPDATE\r\n");
+        if (!stop) {
+            frame = s4375116_cag_display_frame_acquire();
             update_pattern();        
-            update_GRID(); 
-            send_grid_to_display();
-
-            lastTick = currTick;
+            update_GRID(frame); 
+            if (frame != NULL) {
+                s4375116_cag_display_frame_publish(frame);
+            }
+
+            nextGenerationTick += period;
+            if ((int32_t) (nextGenerationTick - xTaskGetTickCount()) < 0) {
+                // more than a period late, skip the missed generations instead of running them back to back
+                nextGenerationTick = xTaskGetTickCount() + period;
+            }
         }
-        currTick = xTaskGetTickCount();
-        
-
-		// Wait for 1000ms 
-		vTaskDelay(10);
 	}
 }
 
@@ -398,6 +501,15 @@ void s4375116TaskCAGSimulator( void ) {
  */
 void s4375116_tsk_cag_simulator_init(void) {
 
+	//queue of commands for the simulator, kept when the task is deleted and created again
+	if (CAGSimulatorMessageQueue == NULL) {
+		CAGSimulatorMessageQueue = xQueueCreate(CAGSIMULATOR_QUEUE_LENGTH, sizeof(caMessage_t));
+	}
+	if (loadFree == NULL) {
+		loadFree = xSemaphoreCreateBinary();
+		xSemaphoreGive(loadFree);
+	}
+
 	xTaskCreate( (void *) &s4375116TaskCAGSimulator, (const signed char *) "CAGSIMULATOR", CAGSIMULATORTASK_STACK_SIZE, NULL, CAGSIMULATORTASK_PRIORITY, &xSimulatorCagTaskHandle );
 
 }
\ No newline at end of file
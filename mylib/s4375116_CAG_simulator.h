@@ -9,6 +9,9 @@
  * EXTERNAL FUNCTIONS
  ***************************************************************
  * s4375116_tsk_cag_simulator_init() - create the game of life simulator controlling task
+ * s4375116_cag_simulator_command() - send a command to the simulator task
+ * s4375116_cag_simulator_load() - replace the grid with a packed grid
+ * s4375116_cag_simulator_step() - step the grid one generation in place (bench command)
  ***************************************************************
  */
 
@@ -16,6 +19,8 @@
 #ifndef S4375116_CAG_SIMULATOR_H
 #define S4375116_CAG_SIMULATOR_H
 
+#include <stdint.h>
+
 #include "event_groups.h"
 
 
@@ -92,21 +97,41 @@ static int glider_gun[9][36] = {
 }; 
 
 
+// caMessage_t types, commands handled by the simulator task in the order they are sent
+#define CA_CMD_START		0x01	// run the simulation
+#define CA_CMD_STOP			0x02	// pause the simulation
+#define CA_CMD_START_STOP	0x03	// toggle between running and paused
+#define CA_CMD_PERIOD		0x04	// x: time between generations (ms)
+#define CA_CMD_CLEAR		0x05	// kill every cell
+#define CA_CMD_LOAD			0x06	// replace the grid (s4375116_cag_simulator_load)
+#define CA_CMD_DOWNLOAD		0x07	// send the grid to the host (s4375116_CAG_link)
+#define CA_CMD_KILL			0x10	// x, y: cell to kill
+#define CA_CMD_SPAWN		0x11	// x, y: cell to bring to life
+// 0x20-0x22 still lifes, 0x30-0x32 oscillators and 0x40 glider are stamped at x, y
+
+#define CAGSIMULATOR_QUEUE_LENGTH	10
+#define CAGSIMULATOR_DEFAULT_PERIOD	1000	// ms between generations
+#define CAGSIMULATOR_MIN_PERIOD		20		// ms, the range of the joystick
+#define CAGSIMULATOR_MAX_PERIOD		10000
+
 struct caMessage {
 	int type;
 	int x;
 	int y;
+	uint32_t inputStamp;	// latency stamp of the key that sent the command
 };
 typedef struct caMessage caMessage_t;
 
-QueueHandle_t CAGSimulatorMessageQueue;	// Queue used
+QueueHandle_t CAGSimulatorMessageQueue;	// Queue of commands for the simulator
 TaskHandle_t xSimulatorCagTaskHandle;
 
-CagDisplayTextMsg sendGridMsg; //message struct sent to CAG_display
 caMessage_t rcvdCaMessage; // message struct which holds the cell/life form to create
 EventBits_t uxBits;
 
 
 void s4375116_tsk_cag_simulator_init(void);
+void s4375116_cag_simulator_command(int type, int x, int y);
+int s4375116_cag_simulator_load(const uint8_t *payload, int len);
+void s4375116_cag_simulator_step(void);
 
 #endif
\ No newline at end of file
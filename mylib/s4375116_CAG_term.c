@@ -0,0 +1,199 @@
+ /**
+ **************************************************************
+ * @file mylib/s4375116_CAG_term.c
+ * @author Sami Kaab - s4375116
+ * @date 19102026
+ * @brief draw the game of life grid on an ANSI terminal
+ * Two grid rows per line using half block characters. The grid is sent once,
+ * after that only the cells that changed are sent with cursor addressing.
+ * Output is collected in a buffer and handed to a write function in large chunks
+ * so it also builds on the host (see host/cag_replay -a)
+ * The lines under the grid are set as the scrolling region so other output
+ * (debug log, cli) scrolls underneath the grid instead of through it.
+ * REFERENCE: ECMA-48 (cursor position, scrolling region, save/restore cursor)
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4375116_lib_cag_term_init() - set the function used to write to the terminal
+ * s4375116_lib_cag_term_reset() - redraw the whole grid on the next render
+ * s4375116_lib_cag_term_render() - send the cells that changed since the last render
+ * s4375116_lib_cag_term_release() - give the whole terminal back to normal output
+ ***************************************************************
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "s4375116_CAG_term.h"
+
+#define TERM_ROWS		((CAG_TERM_MAX_HEIGHT + 1) / 2)
+#define TERM_UNKNOWN	0xFF	// terminal contents not known, always sent
+
+/* changed cells closer than this are sent in one run, a new cursor position costs about as much */
+#define TERM_MERGE_GAP	3
+
+/* UTF-8 half blocks indexed by (bottom << 1) | top */
+static const char *const blocks[4] = {" ", "\xE2\x96\x80", "\xE2\x96\x84", "\xE2\x96\x88"};
+
+static void (*termWrite)(const char *buf, int len);
+static uint8_t shown[TERM_ROWS][CAG_TERM_MAX_WIDTH];	// block on each terminal cell
+static char shownStatus[CAG_TERM_STATUS_MAX + 1];
+static int redraw = 1;
+
+static char out[CAG_TERM_BUFFER_SIZE];
+static int outLen;
+static int outTotal;	// bytes sent by this render
+
+/**
+ * @brief Send the collected output
+ *
+ */
+void term_flush(void) {
+
+	if (outLen > 0 && termWrite != NULL) {
+		termWrite(out, outLen);
+	}
+	outTotal += outLen;
+	outLen = 0;
+}
+
+/**
+ * @brief Add bytes to the output buffer, writing it out whenever it fills up
+ *
+ * @param text bytes to send
+ * @param len number of bytes
+ */
+void term_put(const char *text, int len) {
+
+	for (int i = 0; i < len; i++) {
+		if (outLen == CAG_TERM_BUFFER_SIZE) {
+			term_flush();
+		}
+		out[outLen++] = text[i];
+	}
+}
+
+/**
+ * @brief Add an escape sequence moving the cursor (1 based row and column)
+ *
+ */
+void term_move(int row, int col) {
+
+	char seq[16];
+
+	term_put(seq, snprintf(seq, sizeof(seq), "\033[%d;%dH", row, col));
+}
+
+/**
+ * @brief Get the half block showing two vertically adjacent cells
+ *
+ */
+int term_block(const char *cells, int width, int height, int row, int x) {
+
+	int top = cells[(2 * row) * width + x] != 0;
+	int bottom = (2 * row + 1 < height) && (cells[(2 * row + 1) * width + x] != 0);
+
+	return (bottom << 1) | top;
+}
+
+/*
+ * Set the function used to write to the terminal
+ */
+void s4375116_lib_cag_term_init(void (*write)(const char *buf, int len)) {
+
+	termWrite = write;
+	redraw = 1;
+}
+
+/*
+ * Clear the terminal and redraw the whole grid on the next render
+ */
+void s4375116_lib_cag_term_reset(void) {
+
+	redraw = 1;
+}
+
+/*
+ * Send the cells that changed since the last render and the status line if it changed.
+ * Returns the number of bytes sent
+ */
+int s4375116_lib_cag_term_render(const char *cells, int width, int height, const char *status) {
+
+	int rows = (height + 1) / 2;
+	int runStart;
+	int lastChange;
+	int block;
+	int row;
+	int x;
+	char seq[16];
+
+	if (width > CAG_TERM_MAX_WIDTH || height > CAG_TERM_MAX_HEIGHT) {
+		return 0;
+	}
+
+	outTotal = 0;
+	if (redraw) {
+		// clear, then keep the grid and status line out of the scrolling region
+		term_put("\033[r\033[2J", 7);
+		term_put(seq, snprintf(seq, sizeof(seq), "\033[%d;r", rows + 2));
+		memset(shown, TERM_UNKNOWN, sizeof(shown));
+		shownStatus[0] = '\0';
+		term_move(rows + 2, 1);
+		redraw = 0;
+	}
+	term_put("\0337", 2);	// save the cursor of the normal output
+
+	for (row = 0; row < rows; row++) {
+		runStart = -1;
+		lastChange = -1;
+		for (x = 0; x <= width; x++) {
+			block = (x < width) ? term_block(cells, width, height, row, x) : -1;
+			if (x < width && block == shown[row][x]) {
+				continue;
+			}
+
+			// send the run so far once the next change is too far away
+			if (runStart >= 0 && (x == width || x - lastChange > TERM_MERGE_GAP)) {
+				term_move(row + 1, runStart + 1);
+				for (int i = runStart; i <= lastChange; i++) {
+					shown[row][i] = term_block(cells, width, height, row, i);
+					term_put(blocks[shown[row][i]], strlen(blocks[shown[row][i]]));
+				}
+				runStart = -1;
+			}
+			if (x < width) {
+				if (runStart < 0) {
+					runStart = x;
+				}
+				lastChange = x;
+			}
+		}
+	}
+
+	if (status != NULL && strncmp(status, shownStatus, CAG_TERM_STATUS_MAX) != 0) {
+		strncpy(shownStatus, status, CAG_TERM_STATUS_MAX);
+		term_move(rows + 1, 1);
+		term_put(shownStatus, strlen(shownStatus));
+		term_put("\033[K", 3);	// clear the rest of the line
+	}
+
+	if (outTotal == 0 && outLen == 2) {	// nothing changed, drop the cursor save
+		outLen = 0;
+		return 0;
+	}
+
+	term_put("\0338", 2);	// back to the normal output
+	term_flush();
+	return outTotal;
+}
+
+/*
+ * Give the whole terminal back to normal output, the grid is redrawn on the next render
+ */
+void s4375116_lib_cag_term_release(void) {
+
+	term_put("\033[r\033[2J\033[H", 10);
+	term_flush();
+	redraw = 1;
+}
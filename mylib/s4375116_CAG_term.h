@@ -0,0 +1,35 @@
+ /**
+ **************************************************************
+ * @file mylib/s4375116_CAG_term.h
+ * @author Sami Kaab - s4375116
+ * @date 19102026
+ * @brief draw the game of life grid on an ANSI terminal
+ * Two grid rows per line using half block characters. The grid is sent once,
+ * after that only the cells that changed are sent with cursor addressing.
+ * Output is collected in a buffer and handed to a write function in large chunks
+ * so it also builds on the host (see host/cag_replay -a)
+ * REFERENCE: ECMA-48 (cursor position, scrolling region, save/restore cursor)
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4375116_lib_cag_term_init() - set the function used to write to the terminal
+ * s4375116_lib_cag_term_reset() - redraw the whole grid on the next render
+ * s4375116_lib_cag_term_render() - send the cells that changed since the last render
+ * s4375116_lib_cag_term_release() - give the whole terminal back to normal output
+ ***************************************************************
+ */
+
+#ifndef S4375116_CAG_TERM_H
+#define S4375116_CAG_TERM_H
+
+#define CAG_TERM_MAX_WIDTH		128		// cells
+#define CAG_TERM_MAX_HEIGHT		64		// cells
+#define CAG_TERM_BUFFER_SIZE	256		// bytes collected before each write
+#define CAG_TERM_STATUS_MAX		40		// characters of the status line under the grid
+
+void s4375116_lib_cag_term_init(void (*write)(const char *buf, int len));
+void s4375116_lib_cag_term_reset(void);
+int s4375116_lib_cag_term_render(const char *cells, int width, int height, const char *status);
+void s4375116_lib_cag_term_release(void);
+
+#endif
@@ -0,0 +1,260 @@
+ /**
+ **************************************************************
+ * @file mylib/s4375116_bench.c
+ * @author Sami Kaab - s4375116
+ * @date 19102026
+ * @brief Time hot routines on the board with the DWT cycle counter
+ * Each call of a kernel is timed on its own, so flash wait states, bus contention
+ * and interrupts are all in the numbers. The scheduler is suspended for the whole
+ * run (interrupts still run) so no task sees the grid or the oled half way, and
+ * whatever a kernel changes is put back afterwards.
+ * REFERENCE: ARMv7-M architecture reference manual (DWT_CYCCNT)
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4375116_bench_find() - look up a kernel by name
+ * s4375116_bench_names() - names of every kernel, separated by '|'
+ * s4375116_bench_run() - time a kernel, min/median/max cycles per call
+ ***************************************************************
+ */
+
+#include <string.h>
+
+#include "board.h"
+#include "processor_hal.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "event_groups.h"
+
+#include "s4375116_CAG_display.h"
+#include "s4375116_CAG_simulator.h"
+#include "s4375116_CAG_grid.h"
+#include "s4375116_hamming.h"
+#include "s4375116_lta1000g.h"
+#include "s4375116_joystick.h"
+#include "s4375116_bench.h"
+
+// a routine to time
+struct benchKernel {
+	const char *name;
+	void (*save)(void);			// before the run, may be NULL
+	void (*prepare)(int i);		// before call i, not timed, may be NULL
+	void (*run)(int i);			// call i, timed
+	void (*restore)(void);		// after the run, may be NULL
+};
+
+static uint32_t cycles[BENCH_MAX_ITERATIONS];
+static uint8_t savedGrid[GRID_HEIGHT][GRID_WIDTH];
+static CagDisplayTextMsg benchFrame;
+static uint8_t plain[GRID_WIDTH * GRID_HEIGHT / 8];	// a packed grid snapshot
+static uint8_t coded[2 * sizeof(plain)];
+static char names[96];
+static volatile int sink;	// keeps results of pure routines from being optimised away
+
+/**
+ * @brief Keep the live grid, the step kernel changes it
+ *
+ */
+void bench_grid_save(void) {
+
+	for (int y = 0; y < GRID_HEIGHT; y++) {
+		for (int x = 0; x < GRID_WIDTH; x++) {
+			savedGrid[y][x] = GRID[y][x];
+		}
+	}
+}
+
+void bench_grid_restore(void) {
+
+	for (int y = 0; y < GRID_HEIGHT; y++) {
+		for (int x = 0; x < GRID_WIDTH; x++) {
+			GRID[y][x] = savedGrid[y][x];
+		}
+	}
+}
+
+void bench_step(int i) {
+	s4375116_cag_simulator_step();
+}
+
+/**
+ * @brief Alternate the live grid with an empty one, so every call sends every live cell
+ *
+ */
+void bench_oled_prepare(int i) {
+
+	benchFrame.population = 0;
+	for (int y = 0; y < GRID_HEIGHT; y++) {
+		for (int x = 0; x < GRID_WIDTH; x++) {
+			benchFrame.grid[y][x] = ((i % 2) == 0) && (savedGrid[y][x] != 0);
+			benchFrame.population += benchFrame.grid[y][x];
+		}
+	}
+}
+
+void bench_oled(int i) {
+	s4375116_cag_display_draw(&benchFrame);
+}
+
+/**
+ * @brief Leave the live grid on the oled
+ *
+ */
+void bench_oled_restore(void) {
+
+	bench_oled_prepare(0);
+	s4375116_cag_display_draw(&benchFrame);
+}
+
+void bench_hamming_encode(int i) {
+	sink = s4375116_lib_hamming_byte_encode(i & 0xFF);
+}
+
+void bench_hamming_decode(int i) {
+	sink = s4375116_lib_hamming_byte_decode(i & 0xFF);
+}
+
+/**
+ * @brief Hamming encode a packed grid snapshot, one bit per cell
+ *
+ */
+void bench_hamming_encode_buffer(int i) {
+	s4375116_lib_hamming_encode_buffer(plain, coded, sizeof(plain));
+}
+
+void bench_hamming_decode_buffer(int i) {
+
+	HammingCounts counts;
+
+	s4375116_lib_hamming_decode_buffer(coded, plain, sizeof(coded), &counts);
+}
+
+/**
+ * @brief (72,64) encode the same snapshot, 144 coded bytes instead of 256
+ *
+ */
+void bench_hamming_72_encode_buffer(int i) {
+	s4375116_lib_hamming_72_encode_buffer(plain, coded, sizeof(plain));
+}
+
+void bench_hamming_72_decode_buffer(int i) {
+
+	HammingCounts counts;
+
+	s4375116_lib_hamming_72_decode_buffer(coded, plain, sizeof(plain) / 8 * 9, &counts);
+}
+
+void bench_ledbar(int i) {
+	s4375116_reg_lta1000g_write(i & 0x3FF);
+}
+
+/**
+ * @brief Put the cursor position back on the LED bar, as s4375116_cag_grid_key() shows it
+ *
+ */
+void bench_ledbar_restore(void) {
+	s4375116_reg_lta1000g_write((sendCaMessage.x << 4) | sendCaMessage.y);
+}
+
+void bench_joystick(int i) {
+	sink = s4375116_joystick_read(i & 0x01);
+}
+
+void bench_call(int i) {
+}
+
+static const struct benchKernel kernels[] = {
+	{"step", bench_grid_save, NULL, bench_step, bench_grid_restore},			// simulator generation
+	{"oled", bench_grid_save, bench_oled_prepare, bench_oled, bench_oled_restore},	// display_to_oled, whole grid changing
+	{"hamenc", NULL, NULL, bench_hamming_encode, NULL},
+	{"hamdec", NULL, NULL, bench_hamming_decode, NULL},
+	{"hamencbuf", NULL, NULL, bench_hamming_encode_buffer, NULL},	// 128 bytes
+	{"hamdecbuf", NULL, NULL, bench_hamming_decode_buffer, NULL},	// 256 coded bytes
+	{"h72enc", NULL, NULL, bench_hamming_72_encode_buffer, NULL},	// 128 bytes
+	{"h72dec", NULL, NULL, bench_hamming_72_decode_buffer, NULL},	// 144 coded bytes
+	{"ledbar", NULL, NULL, bench_ledbar, bench_ledbar_restore},
+	{"joystick", NULL, NULL, bench_joystick, NULL},
+	{"call", NULL, NULL, bench_call, NULL},		// cost of the timing itself, in every other result
+};
+
+#define BENCH_KERNELS	(int) (sizeof(kernels) / sizeof(kernels[0]))
+
+/*
+ * Look up a kernel by name (not nul terminated), returns its index or -1
+ */
+int s4375116_bench_find(const char *name, int len) {
+
+	for (int k = 0; k < BENCH_KERNELS; k++) {
+		if ((int) strlen(kernels[k].name) == len && strncmp(kernels[k].name, name, len) == 0) {
+			return k;
+		}
+	}
+	return -1;
+}
+
+/*
+ * Names of every kernel, separated by '|'
+ */
+const char *s4375116_bench_names(void) {
+
+	if (names[0] == '\0') {
+		for (int k = 0; k < BENCH_KERNELS; k++) {
+			strncat(names, (k > 0) ? "|" : "", sizeof(names) - strlen(names) - 1);
+			strncat(names, kernels[k].name, sizeof(names) - strlen(names) - 1);
+		}
+	}
+	return names;
+}
+
+/*
+ * Time iterations calls (at most BENCH_MAX_ITERATIONS) of a kernel.
+ * Returns 0, or -1 if the kernel or iteration count is not valid
+ */
+int s4375116_bench_run(int kernel, int iterations, BenchResult *result) {
+
+	const struct benchKernel *bench;
+	uint32_t start;
+	uint32_t swap;
+
+	if (kernel < 0 || kernel >= BENCH_KERNELS || iterations < 1 || iterations > BENCH_MAX_ITERATIONS) {
+		return -1;
+	}
+	bench = &kernels[kernel];
+
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;	// normally already on for the latency stamps
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	vTaskSuspendAll();
+	if (bench->save != NULL) {
+		bench->save();
+	}
+	for (int i = 0; i < iterations; i++) {
+		if (bench->prepare != NULL) {
+			bench->prepare(i);
+		}
+		start = DWT->CYCCNT;
+		bench->run(i);
+		cycles[i] = DWT->CYCCNT - start;
+	}
+	if (bench->restore != NULL) {
+		bench->restore();
+	}
+	xTaskResumeAll();
+
+	// sort for the median
+	for (int i = 1; i < iterations; i++) {
+		for (int j = i; j > 0 && cycles[j] < cycles[j - 1]; j--) {
+			swap = cycles[j];
+			cycles[j] = cycles[j - 1];
+			cycles[j - 1] = swap;
+		}
+	}
+	result->iterations = iterations;
+	result->min = cycles[0];
+	result->median = cycles[iterations / 2];
+	result->max = cycles[iterations - 1];
+	return 0;
+}
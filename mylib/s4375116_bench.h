@@ -0,0 +1,41 @@
+ /**
+ **************************************************************
+ * @file mylib/s4375116_bench.h
+ * @author Sami Kaab - s4375116
+ * @date 19102026
+ * @brief Time hot routines on the board with the DWT cycle counter
+ * Each call of a kernel is timed on its own, so flash wait states, bus contention
+ * and interrupts are all in the numbers. The scheduler is suspended for the whole
+ * run (interrupts still run) so no task sees the grid or the oled half way, and
+ * whatever a kernel changes is put back afterwards.
+ * REFERENCE: ARMv7-M architecture reference manual (DWT_CYCCNT)
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4375116_bench_find() - look up a kernel by name
+ * s4375116_bench_names() - names of every kernel, separated by '|'
+ * s4375116_bench_run() - time a kernel, min/median/max cycles per call
+ ***************************************************************
+ */
+
+#ifndef S4375116_BENCH_H
+#define S4375116_BENCH_H
+
+#include <stdint.h>
+
+#define BENCH_MAX_ITERATIONS	256		// calls timed per run, all kept for the median
+
+// cycles per call of a run
+struct benchResult {
+	int iterations;
+	uint32_t min;
+	uint32_t median;
+	uint32_t max;
+};
+typedef struct benchResult BenchResult;
+
+int s4375116_bench_find(const char *name, int len);
+const char *s4375116_bench_names(void);
+int s4375116_bench_run(int kernel, int iterations, BenchResult *result);
+
+#endif
@@ -18,6 +18,7 @@
 #include "FreeRTOS.h"
 #include "task.h"
 #include "queue.h"
+#include "semphr.h"
 #include "FreeRTOS_CLI.h"
 #include "oled_pixel.h"
 #include "oled_string.h"
@@ -30,6 +31,17 @@
 #include "s4375116_CAG_grid.h"
 #include "s4375116_CAG_joystick.h"
 #include "s4375116_CAG_simulator.h"
+#include "s4375116_CAG_recorder.h"
+#include "s4375116_latency.h"
+#include "s4375116_joystick.h"
+#include "s4375116_trace.h"
+#include "s4375116_uart_tx.h"
+#include "s4375116_uart_rx.h"
+#include "s4375116_taskstats.h"
+#include "s4375116_bench.h"
+#include "s4375116_console.h"
+#include "s4375116_CAG_link.h"
+#include <stdlib.h>
 
 
 static BaseType_t prvStillCommand(char *cCmd_string, size_t xWriteBufferLen, const char *pcCommandString );
@@ -40,6 +52,13 @@ static BaseType_t prvPauseCommand(char *pcWriteBuffer, size_t xWriteBufferLen, c
 static BaseType_t prvStartCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
 static BaseType_t prvDelCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
 static BaseType_t prvCreCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
+static BaseType_t prvRecCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
+static BaseType_t prvTermCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
+static BaseType_t prvLatCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
+static BaseType_t prvCalCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
+static BaseType_t prvTraceCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
+static BaseType_t prvTopCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
+static BaseType_t prvBenchCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
 
 CLI_Command_Definition_t xStill = {	// Structure that defines the "still" command line command.
 	"still",														// Comamnd String
@@ -97,6 +116,55 @@ CLI_Command_Definition_t xCre = {	// Structure that defines the "del" command li
 	1																// Number of input parameters
 };
 
+CLI_Command_Definition_t xRec = {	// Structure that defines the "rec" command line command.
+	"rec",														// Comamnd String
+	"rec: control the frame recorder, dump prints the recording in hex for host/cag_replay.\r\n rec start|stop|dump\r\n\r\n",	// Help String (Displayed when "help' is typed)
+	prvRecCommand,												// Command Callback that implements the command
+	1																// Number of input parameters
+};
+
+CLI_Command_Definition_t xTerm = {	// Structure that defines the "term" command line command.
+	"term",														// Comamnd String
+	"term: show a live view of the grid at the top of the terminal.\r\n term on|off\r\n\r\n",	// Help String (Displayed when "help' is typed)
+	prvTermCommand,												// Command Callback that implements the command
+	1																// Number of input parameters
+};
+
+CLI_Command_Definition_t xLat = {	// Structure that defines the "lat" command line command.
+	"lat",														// Comamnd String
+	"lat: show the input to screen latency of each stage in us, reset empties the histograms.\r\n lat show|reset\r\n\r\n",	// Help String (Displayed when "help' is typed)
+	prvLatCommand,												// Command Callback that implements the command
+	1																// Number of input parameters
+};
+
+CLI_Command_Definition_t xCal = {	// Structure that defines the "cal" command line command.
+	"cal",														// Comamnd String
+	"cal: joystick calibration, start sweeps the stick range and saves it to flash.\r\n cal start|show\r\n\r\n",	// Help String (Displayed when "help' is typed)
+	prvCalCommand,												// Command Callback that implements the command
+	1																// Number of input parameters
+};
+
+CLI_Command_Definition_t xTrace = {	// Structure that defines the "trace" command line command.
+	"trace",													// Comamnd String
+	"trace: output of the trace log, bin sends records for host/trace_decode.\r\n trace text|bin|off\r\n\r\n",	// Help String (Displayed when "help' is typed)
+	prvTraceCommand,											// Command Callback that implements the command
+	1																// Number of input parameters
+};
+
+CLI_Command_Definition_t xTop = {	// Structure that defines the "top" command line command.
+	"top",														// Comamnd String
+	"top: cpu, state, priority and free stack of each task each second, until a key.\r\n\r\n",	// Help String (Displayed when "help' is typed)
+	prvTopCommand,												// Command Callback that implements the command
+	0																// Number of input parameters
+};
+
+CLI_Command_Definition_t xBench = {	// Structure that defines the "bench" command line command.
+	"bench",													// Comamnd String
+	"bench: min/median/max cycles per call, an unknown name lists the routines.\r\n bench name n\r\n\r\n",	// Help String (Displayed when "help' is typed)
+	prvBenchCommand,											// Command Callback that implements the command
+	2																// Number of input parameters
+};
+
 /*
  * Initialise CLI
  */
@@ -111,6 +179,13 @@ void s4375116_cli_mnemonic_init(void) {
 	FreeRTOS_CLIRegisterCommand(&xStart);
 	FreeRTOS_CLIRegisterCommand(&xDel);
 	FreeRTOS_CLIRegisterCommand(&xCre);
+	FreeRTOS_CLIRegisterCommand(&xRec);
+	FreeRTOS_CLIRegisterCommand(&xTerm);
+	FreeRTOS_CLIRegisterCommand(&xLat);
+	FreeRTOS_CLIRegisterCommand(&xCal);
+	FreeRTOS_CLIRegisterCommand(&xTrace);
+	FreeRTOS_CLIRegisterCommand(&xTop);
+	FreeRTOS_CLIRegisterCommand(&xBench);
 
 }
 
@@ -159,10 +234,7 @@ static BaseType_t prvStillCommand(char *pcWriteBuffer, size_t xWriteBufferLen, c
 	sendCaMessage.x = x;
 	sendCaMessage.y = y;
 	
-	xSemaphoreGive( drawLifeSemaphore );
-	if (CAGSimulatorMessageQueue != NULL) {	// Check if queue exists 
-		xQueueSendToFront(CAGSimulatorMessageQueue, ( void * ) &sendCaMessage, ( portTickType ) 10 );
-	}
+	s4375116_cag_simulator_command(sendCaMessage.type, sendCaMessage.x, sendCaMessage.y);
 
 	xWriteBufferLen = sprintf((char *) pcWriteBuffer, "");
 	return pdFALSE;
@@ -208,10 +280,7 @@ static BaseType_t prvOscCommand(char *pcWriteBuffer, size_t xWriteBufferLen, con
 	sendCaMessage.x = x;
 	sendCaMessage.y = y;
 	
-	xSemaphoreGive( drawLifeSemaphore );
-	if (CAGSimulatorMessageQueue != NULL) {	// Check if queue exists 
-		xQueueSendToFront(CAGSimulatorMessageQueue, ( void * ) &sendCaMessage, ( portTickType ) 10 );
-	}
+	s4375116_cag_simulator_command(sendCaMessage.type, sendCaMessage.x, sendCaMessage.y);
 	xWriteBufferLen = sprintf((char *) pcWriteBuffer, "");
 	return pdFALSE;
 }
@@ -251,10 +320,7 @@ static BaseType_t prvGliderCommand(char *pcWriteBuffer, size_t xWriteBufferLen,
 	sendCaMessage.x = x;
 	sendCaMessage.y = y;
 	
-	xSemaphoreGive( drawLifeSemaphore );
-	if (CAGSimulatorMessageQueue != NULL) {	// Check if queue exists 
-		xQueueSendToFront(CAGSimulatorMessageQueue, ( void * ) &sendCaMessage, ( portTickType ) 10 );
-	}
+	s4375116_cag_simulator_command(sendCaMessage.type, sendCaMessage.x, sendCaMessage.y);
 	xWriteBufferLen = sprintf((char *) pcWriteBuffer, "");
 	return pdFALSE;
 }
@@ -267,7 +333,7 @@ static BaseType_t prvClearCommand(char *pcWriteBuffer, size_t xWriteBufferLen, c
 	long lParam_len;
 	const char *cCmd_string;
 
-	uxBits = xEventGroupSetBits(gridctrlEventGroup, EVT_CLR_GRID);
+	s4375116_cag_simulator_command(CA_CMD_CLEAR, 0, 0);
 
 	/* Return pdFALSE, as there are no more strings to return */
 	/* Only return pdTRUE, if more strings need to be printed */
@@ -284,7 +350,7 @@ static BaseType_t prvPauseCommand(char *pcWriteBuffer, size_t xWriteBufferLen, c
 	const char *cCmd_string;
 
 
-	uxBits = xEventGroupSetBits(joystickctrlEventGroup, EVT_STOP);
+	s4375116_cag_simulator_command(CA_CMD_STOP, 0, 0);
 	/* Return pdFALSE, as there are no more strings to return */
 	/* Only return pdTRUE, if more strings need to be printed */
 	xWriteBufferLen = sprintf((char *) pcWriteBuffer, "");
@@ -300,7 +366,7 @@ static BaseType_t prvStartCommand(char *pcWriteBuffer, size_t xWriteBufferLen, c
 	const char *cCmd_string;
 
 
-	uxBits = xEventGroupSetBits(joystickctrlEventGroup, EVT_START);
+	s4375116_cag_simulator_command(CA_CMD_START, 0, 0);
 	/* Return pdFALSE, as there are no more strings to return */
 	/* Only return pdTRUE, if more strings need to be printed */
 	xWriteBufferLen = sprintf((char *) pcWriteBuffer, "");
@@ -340,12 +406,12 @@ static BaseType_t prvDelCommand(char *pcWriteBuffer, size_t xWriteBufferLen, con
 		xTaskToDelete = xSimulatorCagTaskHandle;
 		xSimulatorCagTaskHandle = NULL; // so that we can create the task again
 		vTaskDelete( xTaskToDelete );
-		debug_log("Deleted the simulator task\n\r");
+		s4375116_uart_tx_printf("Deleted the simulator task\n\r");
 	} else if( task == 1 && xJoystickCagTaskHandle != NULL ) {// check character is a number
 		xTaskToDelete = xJoystickCagTaskHandle;
 		xJoystickCagTaskHandle = NULL; // so that we can create the task again
 		vTaskDelete( xTaskToDelete );
-		debug_log("Deleted the joystick task\n\r");
+		s4375116_uart_tx_printf("Deleted the joystick task\n\r");
 
 	}
 	/* Return pdFALSE, as there are no more strings to return */
@@ -381,10 +447,10 @@ static BaseType_t prvCreCommand(char *pcWriteBuffer, size_t xWriteBufferLen, con
 
 	if (task == 0 && xSimulatorCagTaskHandle == NULL) {
 		s4375116_tsk_cag_simulator_init();
-		debug_log("Created the simulator task\n\r");
+		s4375116_uart_tx_printf("Created the simulator task\n\r");
 	} else if( task == 1 && xJoystickCagTaskHandle == NULL ) {// check character is a number
 		s4375116_tsk_cag_joystick_init();
-		debug_log("Created the joystick task\n\r");
+		s4375116_uart_tx_printf("Created the joystick task\n\r");
 	}
 	
 	/* Return pdFALSE, as there are no more strings to return */
@@ -392,3 +458,310 @@ static BaseType_t prvCreCommand(char *pcWriteBuffer, size_t xWriteBufferLen, con
 	xWriteBufferLen = sprintf((char *) pcWriteBuffer, "");
 	return pdFALSE;
 }
+
+/**
+ * @brief Check a command parameter (not nul terminated) is exactly word, not just a prefix of it
+ *
+ */
+static int param_is(const int8_t *param, BaseType_t len, const char *word) {
+	return param != NULL && (int) strlen(word) == len && strncmp((const char *) param, word, len) == 0;
+}
+
+/*
+ * Recorder Command. dump prints one line of hex per call until the whole recording is out
+ */
+static BaseType_t prvRecCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString ) {
+
+	static int dumpOffset = -1;	// next byte to dump, -1 when not dumping
+	int8_t *pcParameter1;
+	BaseType_t xParameter1StringLength;
+	uint8_t line[32];
+	int count;
+
+	pcParameter1 = FreeRTOS_CLIGetParameter(pcCommandString, 1, &xParameter1StringLength);
+
+	if (param_is(pcParameter1, xParameter1StringLength, "start")) {
+		vTaskSuspendAll();
+		s4375116_lib_cag_recorder_init(GRID_WIDTH, GRID_HEIGHT);
+		xTaskResumeAll();
+		xWriteBufferLen = sprintf((char *) pcWriteBuffer, "Recording\r\n");
+		return pdFALSE;
+
+	} else if (param_is(pcParameter1, xParameter1StringLength, "stop")) {
+		s4375116_lib_cag_recorder_enable(0);
+		xWriteBufferLen = sprintf((char *) pcWriteBuffer, "Stopped, %d bytes recorded\r\n", s4375116_lib_cag_recorder_size());
+		return pdFALSE;
+
+	} else if (!param_is(pcParameter1, xParameter1StringLength, "dump")) {
+		xWriteBufferLen = sprintf((char *) pcWriteBuffer, "rec start|stop|dump\r\n");
+		return pdFALSE;
+	}
+
+	if (dumpOffset < 0) {
+		// hold the recording still while it is printed
+		s4375116_lib_cag_recorder_enable(0);
+		dumpOffset = 0;
+	}
+
+	vTaskSuspendAll();
+	count = s4375116_lib_cag_recorder_read(line, dumpOffset, sizeof(line));
+	xTaskResumeAll();
+
+	if (count == 0) {
+		dumpOffset = -1;
+		s4375116_lib_cag_recorder_enable(1);
+		xWriteBufferLen = sprintf((char *) pcWriteBuffer, "");
+		return pdFALSE;
+	}
+
+	for (int i = 0; i < count; i++) {
+		sprintf((char *) pcWriteBuffer + 2 * i, "%02X", line[i]);
+	}
+	sprintf((char *) pcWriteBuffer + 2 * count, "\r\n");
+	dumpOffset += count;
+	return pdTRUE;
+}
+
+/*
+ * Terminal view Command.
+ */
+static BaseType_t prvTermCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString ) {
+
+	int8_t *pcParameter1;
+	BaseType_t xParameter1StringLength;
+
+	pcParameter1 = FreeRTOS_CLIGetParameter(pcCommandString, 1, &xParameter1StringLength);
+
+	if (param_is(pcParameter1, xParameter1StringLength, "on")) {
+		s4375116_cag_display_term(1);
+	} else if (param_is(pcParameter1, xParameter1StringLength, "off")) {
+		s4375116_cag_display_term(0);
+	} else {
+		xWriteBufferLen = sprintf((char *) pcWriteBuffer, "term on|off\r\n");
+		return pdFALSE;
+	}
+
+	xWriteBufferLen = sprintf((char *) pcWriteBuffer, "");
+	return pdFALSE;
+}
+
+/*
+ * Latency Command. show prints one line per call, a summary of each stage followed by its non empty buckets
+ */
+static BaseType_t prvLatCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString ) {
+
+	static int stage = -1;	// stage being printed, -1 when not printing
+	static int bucket;		// next bucket of the stage, -1 for the summary line
+	static LatencyHist hist;
+	int8_t *pcParameter1;
+	BaseType_t xParameter1StringLength;
+
+	if (stage < 0) {
+		pcParameter1 = FreeRTOS_CLIGetParameter(pcCommandString, 1, &xParameter1StringLength);
+
+		if (param_is(pcParameter1, xParameter1StringLength, "reset")) {
+			s4375116_latency_reset();
+			xWriteBufferLen = sprintf((char *) pcWriteBuffer, "Latency histograms cleared\r\n");
+			return pdFALSE;
+		} else if (!param_is(pcParameter1, xParameter1StringLength, "show")) {
+			xWriteBufferLen = sprintf((char *) pcWriteBuffer, "lat show|reset\r\n");
+			return pdFALSE;
+		}
+		stage = 0;
+		bucket = -1;
+		s4375116_latency_get(stage, &hist);
+	}
+
+	if (bucket < 0) {
+		if (hist.count == 0) {
+			xWriteBufferLen = sprintf((char *) pcWriteBuffer, "%-12s no samples\r\n", s4375116_latency_stage_name(stage));
+		} else {
+			xWriteBufferLen = sprintf((char *) pcWriteBuffer, "%-12s n=%lu min=%lu avg=%lu max=%lu us\r\n",
+					s4375116_latency_stage_name(stage), (unsigned long) hist.count, (unsigned long) hist.min,
+					(unsigned long) (hist.total / hist.count), (unsigned long) hist.max);
+		}
+		bucket = 0;
+	} else if (bucket == LATENCY_BUCKETS - 1) {
+		xWriteBufferLen = sprintf((char *) pcWriteBuffer, "  >=%lu us: %lu\r\n", 1UL << bucket, (unsigned long) hist.buckets[bucket]);
+		bucket++;
+	} else {
+		xWriteBufferLen = sprintf((char *) pcWriteBuffer, "  <%lu us: %lu\r\n", 2UL << bucket, (unsigned long) hist.buckets[bucket]);
+		bucket++;
+	}
+
+	// skip to the next non empty bucket, or the next stage once every bucket of this one is out
+	while (bucket >= 0 && bucket < LATENCY_BUCKETS && hist.buckets[bucket] == 0) {
+		bucket++;
+	}
+	if (bucket == LATENCY_BUCKETS) {
+		if (++stage == LATENCY_STAGES) {
+			stage = -1;
+			return pdFALSE;
+		}
+		bucket = -1;
+		s4375116_latency_get(stage, &hist);
+	}
+	return pdTRUE;
+}
+
+/*
+ * Joystick calibration Command.
+ */
+static BaseType_t prvCalCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString ) {
+
+	int8_t *pcParameter1;
+	BaseType_t xParameter1StringLength;
+	JoystickCal cal;
+
+	pcParameter1 = FreeRTOS_CLIGetParameter(pcCommandString, 1, &xParameter1StringLength);
+
+	if (param_is(pcParameter1, xParameter1StringLength, "start")) {
+		s4375116_joystick_cal_start();
+		xWriteBufferLen = sprintf((char *) pcWriteBuffer, "");
+	} else if (param_is(pcParameter1, xParameter1StringLength, "show")) {
+		s4375116_joystick_cal_get(&cal);
+		xWriteBufferLen = sprintf((char *) pcWriteBuffer, "x=%d/%d/%d y=%d/%d/%d (min/centre/max)\r\n",
+				cal.min[JOYSTICK_AXIS_X], cal.centre[JOYSTICK_AXIS_X], cal.max[JOYSTICK_AXIS_X],
+				cal.min[JOYSTICK_AXIS_Y], cal.centre[JOYSTICK_AXIS_Y], cal.max[JOYSTICK_AXIS_Y]);
+	} else {
+		xWriteBufferLen = sprintf((char *) pcWriteBuffer, "cal start|show\r\n");
+	}
+	return pdFALSE;
+}
+
+/*
+ * Trace log Command.
+ */
+static BaseType_t prvTraceCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString ) {
+
+	int8_t *pcParameter1;
+	BaseType_t xParameter1StringLength;
+
+	pcParameter1 = FreeRTOS_CLIGetParameter(pcCommandString, 1, &xParameter1StringLength);
+
+	if (param_is(pcParameter1, xParameter1StringLength, "text")) {
+		s4375116_trace_mode(TRACE_MODE_TEXT);
+	} else if (param_is(pcParameter1, xParameter1StringLength, "bin")) {
+		s4375116_trace_mode(TRACE_MODE_BINARY);
+	} else if (param_is(pcParameter1, xParameter1StringLength, "off")) {
+		s4375116_trace_mode(TRACE_MODE_OFF);
+	} else {
+		xWriteBufferLen = sprintf((char *) pcWriteBuffer, "trace text|bin|off\r\n");
+		return pdFALSE;
+	}
+	xWriteBufferLen = sprintf((char *) pcWriteBuffer, "%lu trace records dropped so far\r\n", s4375116_trace_dropped());
+	return pdFALSE;
+}
+
+/**
+ * @brief Wait up to wait ticks for a key that stops top, the console task runs the cli so its
+ * input is read here. Host link frames are still passed to the link, and a pushbutton press
+ * stops top and is handed back to the console task to switch mode.
+ *
+ * @return int 1 if top should stop
+ */
+static int top_wait_key(TickType_t wait) {
+
+	TickType_t start = xTaskGetTickCount();
+	TickType_t waited;
+	uint32_t notifyBits;
+	char c;
+
+	for (;;) {
+		while (s4375116_uart_rx_read(&c)) {
+			if (!s4375116_cag_link_input(c)) {
+				return 1;
+			}
+		}
+		waited = xTaskGetTickCount() - start;
+		if (waited >= wait) {
+			return 0;
+		}
+		if (xTaskNotifyWait(0, CONSOLE_NOTIFY_ALL, &notifyBits, wait - waited) == pdTRUE &&
+				(notifyBits & CONSOLE_NOTIFY_MODE)) {
+			xTaskNotify(xTaskGetCurrentTaskHandle(), CONSOLE_NOTIFY_MODE, eSetBits);
+			return 1;
+		}
+	}
+}
+
+/*
+ * Task usage Command. Each call prints one line of the table, the table is redrawn
+ * over the previous one every TOP_PERIOD_MS until a character is received.
+ */
+static BaseType_t prvTopCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString ) {
+
+	static TaskStatsTask tasks[TASKSTATS_MAX_TASKS];
+	static int count;
+	static int row = -1;	// next task to print, -1 to take a new sample
+	static int shown = 0;	// lines of the table on the terminal
+	static uint32_t elapsed;
+	static const char states[] = "XRBSD";	// by eTaskState, as vTaskList()
+	TaskStatsTask swap;
+	uint32_t tenths;
+	int len;
+
+	if (row < 0) {
+		if (shown == 0) {
+			s4375116_taskstats_sample(tasks, TASKSTATS_MAX_TASKS, &elapsed);	// start of the first period
+		}
+		if (top_wait_key(pdMS_TO_TICKS(TOP_PERIOD_MS))) {
+			shown = 0;
+			xWriteBufferLen = sprintf((char *) pcWriteBuffer, "");
+			return pdFALSE;
+		}
+		count = s4375116_taskstats_sample(tasks, TASKSTATS_MAX_TASKS, &elapsed);
+
+		// busiest first
+		for (int i = 1; i < count; i++) {
+			for (int j = i; j > 0 && tasks[j].runTime > tasks[j - 1].runTime; j--) {
+				swap = tasks[j];
+				tasks[j] = tasks[j - 1];
+				tasks[j - 1] = swap;
+			}
+		}
+
+		len = (shown > 0) ? sprintf((char *) pcWriteBuffer, "\033[%dA", shown) : 0;	// back up over the last table
+		sprintf((char *) pcWriteBuffer + len, "%-16s st pri   cpu  stack\033[K\r\n", "task");
+		row = 0;
+		return pdTRUE;
+	}
+
+	tenths = (elapsed > 0) ? (uint32_t) (((uint64_t) tasks[row].runTime * 1000) / elapsed) : 0;
+	len = sprintf((char *) pcWriteBuffer, "%-16s %c  %2lu %3lu.%lu%% %6lu\033[K\r\n", tasks[row].status.pcTaskName,
+			(tasks[row].status.eCurrentState <= eDeleted) ? states[tasks[row].status.eCurrentState] : '?',
+			(unsigned long) tasks[row].status.uxCurrentPriority, (unsigned long) (tenths / 10), (unsigned long) (tenths % 10),
+			(unsigned long) tasks[row].status.usStackHighWaterMark);
+
+	if (++row == count) {
+		sprintf((char *) pcWriteBuffer + len, "\033[J");	// clear lines left by tasks since deleted
+		shown = count + 1;
+		row = -1;
+	}
+	return pdTRUE;
+}
+
+/*
+ * Bench Command.
+ */
+static BaseType_t prvBenchCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString ) {
+
+	int8_t *pcParameter1, *pcParameter2;
+	BaseType_t xParameter1StringLength, xParameter2StringLength;
+	BenchResult result;
+	int kernel;
+
+	pcParameter1 = FreeRTOS_CLIGetParameter(pcCommandString, 1, &xParameter1StringLength);
+	pcParameter2 = FreeRTOS_CLIGetParameter(pcCommandString, 2, &xParameter2StringLength);
+
+	kernel = s4375116_bench_find((char *) pcParameter1, xParameter1StringLength);
+
+	if (kernel < 0 || s4375116_bench_run(kernel, atoi((char *) pcParameter2), &result) < 0) {
+		xWriteBufferLen = sprintf((char *) pcWriteBuffer, "bench %s 1..%d\r\n", s4375116_bench_names(), BENCH_MAX_ITERATIONS);
+		return pdFALSE;
+	}
+	xWriteBufferLen = sprintf((char *) pcWriteBuffer, "%.*s n=%d min=%lu median=%lu max=%lu cycles (%lu MHz)\r\n",
+			(int) xParameter1StringLength, (char *) pcParameter1, result.iterations, (unsigned long) result.min,
+			(unsigned long) result.median, (unsigned long) result.max, (unsigned long) (SystemCoreClock / 1000000));
+	return pdFALSE;
+}
@@ -17,6 +17,8 @@
 
 #include "event_groups.h"
 
+#define TOP_PERIOD_MS	1000	// refresh period of the top command
+
 EventBits_t uxBits;
 
 void s4375116_cli_mnemonic_init(void);
@@ -3,12 +3,13 @@
  * @file mylib/s4375116_cli_task.c
  * @author Sami Kaab - s4375116 
  * @date 22052022
- * @brief task functions to get and parse cli commands
+ * @brief cli line editor, gets and parses cli commands
+ * Characters are passed in by the console task (s4375116_console.c) while in mnemonic mode
  * REFERENCE: csse3010_project.pdf
  ***************************************************************
  * EXTERNAL FUNCTIONS
  ***************************************************************
- * s4375116_cli_init() - creates the task that runs the cli cyclic executive
+ * s4375116_cli_input() - add a received character to the command line, runs it on return
  ***************************************************************
  */
 
@@ -28,148 +29,75 @@
 #include "s4375116_cli_mnemonic.h"
 #include "s4375116_cli_task.h"
 #include "s4375116_CAG_grid.h"
+#include "s4375116_uart_tx.h"
 
 
-void CLI_Task(void);
-void s4375116_cli_init(void);
-void cli_hardware_init( void );
+static char cInputString[100];	// command line being typed
+static int InputIndex = 0;
 
-int cliMode = 0;
-
-/*
- * Initialise CLI
+/**
+ * @brief Run the command line through the CLI and print everything it returns
+ * 
  */
-void s4375116_cli_init(void) {
+void cli_process_line(void) {
+
+	char *pcOutputString = FreeRTOS_CLIGetOutputBuffer();
+	BaseType_t xReturned = pdTRUE;
+
+	/* Process command input string. */
+	while (xReturned != pdFALSE) {
+
+		/* Returns pdFALSE, when all strings have been returned */
+		xReturned = FreeRTOS_CLIProcessCommand( cInputString, pcOutputString, configCOMMAND_INT_MAX_OUTPUT_SIZE );
 
-	/* Create CLI Receiving task */
-	xTaskCreate( (void *) &CLI_Task, (const signed char *) "CLI", CLI_TASK_STACK_SIZE, NULL, CLI_PRIORITY, NULL );
+		/* Display CLI command output string, waits for room so long output (rec dump) is not cut */
+		s4375116_uart_tx_write(pcOutputString, strlen(pcOutputString), portMAX_DELAY);
+	}
 
+	memset(cInputString, 0, sizeof(cInputString));
+	InputIndex = 0;
 }
 
 /*
- * CLI Receiving Task.
+ * Line editor, called by the console task with every character received in mnemonic mode
  */
-void CLI_Task(void) {
+void s4375116_cli_input(char cRxedChar) {
 
-	cli_hardware_init();
+	/* Echo character */
+	s4375116_uart_tx_write(&cRxedChar, 1, portMAX_DELAY);
 
+	/* Process only if return is received. */
+	if (cRxedChar == '\r') {
 
-	int i;
-	char cRxedChar;
-	char cInputString[100];
-	int InputIndex = 0;
-	char *pcOutputString;
-	BaseType_t xReturned;
+		//Put new line
+		s4375116_uart_tx_write("\n", 1, portMAX_DELAY);
 
+		/* Put null character in command input string. */
+		cInputString[InputIndex] = '\0';
 
-	/* Initialise pointer to CLI output buffer. */
-	memset(cInputString, 0, sizeof(cInputString));
-	pcOutputString = FreeRTOS_CLIGetOutputBuffer();
+		cli_process_line();
 
-	for (;;) {
-
-		//check if onboard pushbutton was pressed
-		if (gridModeSemaphore != NULL) {	// Check if semaphore exists
-			/* See if we can obtain the PB semaphore. If the semaphore is not available
-			wait 10 ticks to see if it becomes free. */
-			if( xSemaphoreTake( gridModeSemaphore, 10 ) == pdTRUE ) {
-				
-				cliMode = !cliMode;
-				debug_log("Mode: %s\r\n", cliMode ? "Mnemonic" : "Grid");
+	} else {
 
+		if( cRxedChar == 127 ) {
+			
+			/* Backspace was pressed.  Erase the last character in the
+			string - if any.*/
+			if( InputIndex > 0 ) {
+				InputIndex--;
+				s4375116_uart_tx_write("\033[1D \033[1D", 9, portMAX_DELAY);	//move cursor back over a blank
+				cInputString[ InputIndex ] = '\0';
 			}
-		}
 
-		if (cliMode) {
-			/* Receive character from terminal */
-			cRxedChar = debug_getc();
-
-			/* Process if character if not Null */
-			if (cRxedChar != '\0') {
-
-				/* Echo character */
-				debug_putc(cRxedChar);
-				
-
-				/* Process only if return is received. */
-				if (cRxedChar == '\r') {
-
-					//Put new line and transmit buffer
-					debug_putc('\n');
-					debug_flush();
-
-					/* Put null character in command input string. */
-					cInputString[InputIndex] = '\0';
-
-					xReturned = pdTRUE;
-					/* Process command input string. */
-					while (xReturned != pdFALSE) {
-
-						/* Returns pdFALSE, when all strings have been returned */
-						xReturned = FreeRTOS_CLIProcessCommand( cInputString, pcOutputString, configCOMMAND_INT_MAX_OUTPUT_SIZE );
-
-						/* Display CLI command output string (not thread safe) */
-						portENTER_CRITICAL();
-						for (i = 0; i < (int) strlen(pcOutputString); i++) {
-							debug_putc(*(pcOutputString + i));
-						}
-						portEXIT_CRITICAL();
-
-						vTaskDelay(5);	//Must delay between debug_printfs.
-					}
-
-					memset(cInputString, 0, sizeof(cInputString));
-					InputIndex = 0;
-
-				} else {
-
-					debug_flush();		//Transmit USB buffer
-
-					if( cRxedChar == '\r' ) {
-
-						/* Ignore the character. */
-					} else if( cRxedChar == 127 ) {
-						
-						/* Backspace was pressed.  Erase the last character in the
-						string - if any.*/
-						if( InputIndex > 0 ) {
-							InputIndex--;
-							debug_log("\033[1D");//move currsor back
-							debug_putc(' ');
-							debug_log("\033[1D");//move currsor back
-							cInputString[ InputIndex ] = '\0';
-						}
-
-					} else {
-
-						/* A character was entered.  Add it to the string
-						entered so far.  When a \n is entered the complete
-						string will be passed to the command interpreter. */
-						if( InputIndex < 20 ) {
-							cInputString[ InputIndex ] = cRxedChar;
-							InputIndex++;
-						}
-					}
-				}
+		} else {
+
+			/* A character was entered.  Add it to the string
+			entered so far.  When a \n is entered the complete
+			string will be passed to the command interpreter. */
+			if( InputIndex < (int) sizeof(cInputString) - 1 ) {
+				cInputString[ InputIndex ] = cRxedChar;
+				InputIndex++;
 			}
 		}
-
-		
-
-		vTaskDelay(50);
-		
 	}
 }
-
-/*
- * Hardware Initialisation.
- */
-void cli_hardware_init( void ) {
-
-	portDISABLE_INTERRUPTS();	//Disable interrupts
-
-	BRD_LEDInit();				//Initialise Green LED
-	BRD_debuguart_init();  		//Initialise UART for debug log output
-
-	portENABLE_INTERRUPTS();	//Enable interrupts
-}
@@ -0,0 +1,198 @@
+ /**
+ **************************************************************
+ * @file mylib/s4375116_console.c
+ * @author Sami Kaab - s4375116
+ * @date 19102026
+ * @brief task that owns the console input
+ * Received characters go to the CAG grid key handler or the CLI line editor
+ * depending on the input mode, the onboard pushbutton switches mode.
+ * Host link frames (s4375116_CAG_link) are taken out first in either mode.
+ * The task sleeps until the uart receive interrupt or a debounced pushbutton press (s4375116_debounce.c)
+ * notifies it, so input is handled as soon as it arrives and a mode switch
+ * applies to the very next character.
+ * REFERENCE: csse3010_project.pdf
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4375116_tsk_console_init() - create the console input task
+ * s4375116_console_mode_get() - get the current input mode
+ * s4375116_console_input_stamp() - latency stamp of the input being handled
+ ***************************************************************
+ */
+
+#include "board.h"
+#include "processor_hal.h"
+#include "debug_log.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+#include "s4375116_uart_rx.h"
+#include "s4375116_debounce.h"
+#include "s4375116_latency.h"
+#include "s4375116_console.h"
+#include "s4375116_CAG_grid.h"
+#include "s4375116_cli_task.h"
+#include "s4375116_trace.h"
+#include "s4375116_CAG_link.h"
+
+static TaskHandle_t consoleTaskHandle = NULL;
+static volatile int consoleMode = CONSOLE_MODE_GRID;
+static uint32_t inputStamp = LATENCY_NONE;	// when the characters being handled were received
+
+static int pbButton = -1;	// debounced onboard pushbutton
+
+/*
+ * Debounced push button event (timer interrupt), a press asks the console task to switch mode
+ */
+void pb_event(const DebounceEvent *event, BaseType_t *woken) {
+
+	if (event->type == DEBOUNCE_PRESS && consoleTaskHandle != NULL) {	// Check if task exists
+		xTaskNotifyFromISR(consoleTaskHandle, CONSOLE_NOTIFY_MODE, eSetBits, woken);
+	}
+}
+
+/*
+ * Initialise onboard push button Hardware
+ */
+void onboard_pushbutton_hardware_init(void) {
+
+	DebounceButton button;
+
+	// Enable GPIO Clock
+	__GPIOC_CLK_ENABLE();
+
+    GPIOC->OSPEEDR |= (GPIO_SPEED_FAST << 13);	//Set fast speed.
+	GPIOC->PUPDR &= ~(0x03 << (13 * 2));			//Clear bits for no push/pull
+	GPIOC->MODER &= ~(0x03 << (13 * 2));			//Clear bits for input mode
+
+	// Enable EXTI clock
+	RCC->APB2ENR |= RCC_APB2ENR_SYSCFGEN;
+
+	//select trigger source (port c, pin 13) on EXTICR4.
+	SYSCFG->EXTICR[3] &= ~SYSCFG_EXTICR4_EXTI13;
+	SYSCFG->EXTICR[3] |= SYSCFG_EXTICR4_EXTI13_PC;
+
+	EXTI->RTSR |= EXTI_RTSR_TR13;	//enable rising dedge
+	EXTI->FTSR |= EXTI_FTSR_TR13;	//enable falling edge, either edge starts debouncing
+	EXTI->IMR |= EXTI_IMR_IM13;		//Enable external interrupt
+
+	//Enable priority (10) and interrupt callback. Do not set a priority lower than 5.
+	HAL_NVIC_SetPriority(EXTI15_10_IRQn, 10, 0);
+	HAL_NVIC_EnableIRQ(EXTI15_10_IRQn);
+
+	// pressed pulls C13 high
+	button.port = GPIOC;
+	button.pin = 13;
+	button.activeLevel = 1;
+	button.queue = NULL;
+	button.callback = pb_event;
+	pbButton = s4375116_reg_debounce_add(&button);
+}
+
+/*
+ * Interrupt handler (ISR) for EXTI 15 to 10 IRQ Handler
+ * Note ISR should only execute a callback
+ */ 
+void EXTI15_10_IRQHandler(void) {
+
+	NVIC_ClearPendingIRQ(EXTI15_10_IRQn);
+
+	// PR: Pending register
+	if ((EXTI->PR & EXTI_PR_PR13) == EXTI_PR_PR13) {
+
+		// cleared by writing a 1 to this bit
+		EXTI->PR |= EXTI_PR_PR13;	//Clear interrupt flag.
+
+		s4375116_reg_debounce_edge(pbButton);   // C13 changed, debounce it
+	}
+}
+
+/*
+ * Get the current input mode (CONSOLE_MODE_GRID or CONSOLE_MODE_CLI)
+ */
+int s4375116_console_mode_get(void) {
+	return consoleMode;
+}
+
+/*
+ * Latency stamp of the input being handled, LATENCY_NONE outside the console task
+ * (a command sent by the joystick is not timed as a key)
+ */
+uint32_t s4375116_console_input_stamp(void) {
+
+	if (xTaskGetCurrentTaskHandle() != consoleTaskHandle) {
+		return LATENCY_NONE;
+	}
+	return inputStamp;
+}
+
+/**
+ * @brief initialise the console hardware
+ * 
+ */
+void console_hardware_init(void) {
+
+	portDISABLE_INTERRUPTS();	//Disable interrupts
+
+	BRD_LEDInit();				//Initialise LEDS
+	BRD_debuguart_init();		//Initialise UART for debug log output
+	s4375116_reg_uart_rx_init();	//Receive input by interrupt
+	s4375116_reg_uart_tx_init();	//Send output by DMA
+	s4375116_reg_latency_init();	//Time input to screen latency
+	onboard_pushbutton_hardware_init();
+
+	portENABLE_INTERRUPTS();	//Enable interrupts
+}
+
+/**
+ * @brief Console task, routes every received character to the handler of the current mode
+ * 
+ */
+void s4375116TaskConsole(void) {
+
+	uint32_t notifyBits;
+	char c;
+
+	console_hardware_init();
+	s4375116_uart_rx_set_reader(xTaskGetCurrentTaskHandle());
+
+	s4375116_cag_grid_init();
+
+	TRACE_LOG("Mode: Grid\r\n");
+
+	for (;;) {
+
+		// sleep until a character is received or the pushbutton is pressed
+		xTaskNotifyWait(0, CONSOLE_NOTIFY_ALL, &notifyBits, portMAX_DELAY);
+		inputStamp = s4375116_latency_now();
+
+		if (notifyBits & CONSOLE_NOTIFY_MODE) {
+			consoleMode = (consoleMode == CONSOLE_MODE_GRID) ? CONSOLE_MODE_CLI : CONSOLE_MODE_GRID;
+			BRD_LEDGreenToggle();
+			TRACE_LOG("Mode: %s\r\n", (consoleMode == CONSOLE_MODE_CLI) ? "Mnemonic" : "Grid");
+		}
+
+		// the ring may hold more than one character per notification
+		while (s4375116_uart_rx_read(&c)) {
+			if (s4375116_cag_link_input(c)) {
+				// part of a host link frame (s4375116_CAG_proto)
+			} else if (consoleMode == CONSOLE_MODE_CLI) {
+				s4375116_cli_input(c);
+			} else {
+				s4375116_cag_grid_key(c);
+			}
+		}
+		inputStamp = LATENCY_NONE;
+	}
+}
+
+/*
+ * Create the console input task
+ */
+void s4375116_tsk_console_init(void) {
+
+	xTaskCreate( (void *) &s4375116TaskConsole, (const signed char *) "CONSOLE", CONSOLETASK_STACK_SIZE, NULL, CONSOLETASK_PRIORITY, &consoleTaskHandle );
+
+}
@@ -0,0 +1,44 @@
+ /**
+ **************************************************************
+ * @file mylib/s4375116_console.h
+ * @author Sami Kaab - s4375116
+ * @date 19102026
+ * @brief task that owns the console input
+ * Received characters go to the CAG grid key handler or the CLI line editor
+ * depending on the input mode, the onboard pushbutton switches mode.
+ * Host link frames (s4375116_CAG_link) are taken out first in either mode.
+ * REFERENCE: csse3010_project.pdf
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4375116_tsk_console_init() - create the console input task
+ * s4375116_console_mode_get() - get the current input mode
+ * s4375116_console_input_stamp() - latency stamp of the input being handled
+ ***************************************************************
+ */
+
+#ifndef S4375116_CONSOLE_H
+#define S4375116_CONSOLE_H
+
+#include <stdint.h>
+
+// Task Priorities (Idle Priority is the lowest priority)
+#define CONSOLETASK_PRIORITY		( tskIDLE_PRIORITY + 2 )
+
+// Task Stack Allocations (must be a multiple of the minimal stack size)
+#define CONSOLETASK_STACK_SIZE		( configMINIMAL_STACK_SIZE * 4 )
+
+// Input modes
+#define CONSOLE_MODE_GRID		0	// single key grid control
+#define CONSOLE_MODE_CLI		1	// mnemonic command line
+
+// Console task notification bits
+#define CONSOLE_NOTIFY_RX		UART_RX_NOTIFY_BIT	// characters received
+#define CONSOLE_NOTIFY_MODE		(1UL << 1)			// pushbutton pressed, switch mode
+#define CONSOLE_NOTIFY_ALL		(CONSOLE_NOTIFY_RX | CONSOLE_NOTIFY_MODE)
+
+void s4375116_tsk_console_init(void);
+int s4375116_console_mode_get(void);
+uint32_t s4375116_console_input_stamp(void);
+
+#endif
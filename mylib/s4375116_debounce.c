@@ -0,0 +1,216 @@
+ /**
+ **************************************************************
+ * @file mylib/s4375116_debounce.c
+ * @author Sami Kaab - s4375116
+ * @date 19102026
+ * @brief Push button debouncing shared by every button
+ * The first edge of a button masks its EXTI line and starts a periodic timer that
+ * samples the pin, so contact bounce causes no further interrupts. A level held for
+ * DEBOUNCE_STABLE_SAMPLES samples is accepted and sent as a press or release event,
+ * a press held for DEBOUNCE_LONG_PRESS_MS also sends a long press event.
+ * Once the button is released and stable the EXTI line is unmasked again and the
+ * timer stops when no button is being sampled.
+ * REFERENCE: STM32F429 reference manual (RM0090) EXTI and basic timer chapters
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4375116_reg_debounce_add() - debounce a button whose EXTI line is already set up
+ * s4375116_reg_debounce_edge() - call from the EXTI interrupt of a button
+ ***************************************************************
+ */
+
+#include "board.h"
+#include "processor_hal.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+#include "s4375116_debounce.h"
+
+#define TIMER_COUNTER_FREQ	10000	// Hz
+
+// state of a debounced button
+struct buttonState {
+	DebounceButton config;
+	volatile uint8_t sampling;	// EXTI masked, the timer samples the pin
+	uint8_t pressed;			// accepted state
+	uint8_t changeCount;		// consecutive samples differing from the accepted state
+	uint8_t stableCount;		// consecutive samples equal to the accepted state
+	uint8_t longSent;			// long press event sent for this press
+	uint32_t pressTick;			// HAL tick the press was accepted
+};
+
+static struct buttonState buttons[DEBOUNCE_MAX_BUTTONS];
+static int buttonCount = 0;
+
+/**
+ * @brief Set up the sampling timer, it only runs while a button is being sampled
+ * 
+ */
+void debounce_timer_init(void) {
+
+	__TIM7_CLK_ENABLE();
+
+	// Set clock prescaler to 10kHz, the timer runs at twice the APB1 clock
+	DEBOUNCE_TIMER->PSC = ((SystemCoreClock / 2) / TIMER_COUNTER_FREQ) - 1;
+	DEBOUNCE_TIMER->ARR = (TIMER_COUNTER_FREQ / 1000) * DEBOUNCE_SAMPLE_MS - 1;	// one update per sample
+	DEBOUNCE_TIMER->EGR = TIM_EGR_UG;		// load the prescaler now
+	DEBOUNCE_TIMER->SR &= ~TIM_SR_UIF;
+	DEBOUNCE_TIMER->DIER |= TIM_DIER_UIE;	// Enable update interrupt
+
+	//Enable priority (10) and interrupt callback. Do not set a priority lower than 5.
+	HAL_NVIC_SetPriority(DEBOUNCE_TIMER_IRQ, 10, 0);
+	HAL_NVIC_EnableIRQ(DEBOUNCE_TIMER_IRQ);
+}
+
+/**
+ * @brief Read a button, 1 if it is held down
+ * 
+ */
+int button_level(const struct buttonState *button) {
+	return ((button->config.port->IDR >> button->config.pin) & 0x01) == button->config.activeLevel;
+}
+
+/**
+ * @brief Send an event to the queue and callback of a button
+ * 
+ */
+void button_event(int id, uint8_t type, uint32_t tick, BaseType_t *woken) {
+
+	DebounceEvent event;
+
+	event.button = id;
+	event.type = type;
+	event.tick = tick;
+
+	if (buttons[id].config.queue != NULL) {	// Check if queue exists
+		xQueueSendFromISR(buttons[id].config.queue, &event, woken);
+	}
+	if (buttons[id].config.callback != NULL) {
+		buttons[id].config.callback(&event, woken);
+	}
+}
+
+/**
+ * @brief Take one sample of a button, unmask its EXTI line once it is released and stable
+ * 
+ */
+void button_sample(int id, BaseType_t *woken) {
+
+	struct buttonState *button = &buttons[id];
+	uint32_t now = HAL_GetTick();
+	int level = button_level(button);
+
+	if (level != button->pressed) {
+		button->stableCount = 0;
+		if (++button->changeCount < DEBOUNCE_STABLE_SAMPLES) {
+			return;
+		}
+		// the new level held long enough
+		button->pressed = level;
+		button->changeCount = 0;
+		if (level) {
+			button->pressTick = now;
+			button->longSent = 0;
+		}
+		button_event(id, level ? DEBOUNCE_PRESS : DEBOUNCE_RELEASE, now, woken);
+		return;
+	}
+
+	button->changeCount = 0;
+	if (button->stableCount < DEBOUNCE_STABLE_SAMPLES) {
+		button->stableCount++;
+	}
+
+	if (button->pressed) {
+		if (!button->longSent && (now - button->pressTick) >= DEBOUNCE_LONG_PRESS_MS) {
+			button->longSent = 1;
+			button_event(id, DEBOUNCE_LONG_PRESS, now, woken);
+		}
+	} else if (button->stableCount == DEBOUNCE_STABLE_SAMPLES) {
+		// released and settled, wait for the next edge
+		EXTI->PR = (0x01 << button->config.pin);	// cleared by writing a 1 to this bit
+		EXTI->IMR |= (0x01 << button->config.pin);
+		button->sampling = 0;
+
+		// a masked edge is not latched, catch a press that came in before the line was unmasked
+		if (button_level(button)) {
+			EXTI->IMR &= ~(0x01 << button->config.pin);
+			button->sampling = 1;
+		}
+	}
+}
+
+/*
+ * Debounce a button whose EXTI line is already set up on both edges.
+ * Returns the button id passed to s4375116_reg_debounce_edge(), or -1 if there is no room
+ */
+int s4375116_reg_debounce_add(const DebounceButton *button) {
+
+	int id;
+
+	if (buttonCount == DEBOUNCE_MAX_BUTTONS) {
+		return -1;
+	}
+	if (buttonCount == 0) {
+		debounce_timer_init();
+	}
+
+	id = buttonCount;
+	buttons[id].config = *button;
+	buttons[id].pressed = 0;
+	buttons[id].changeCount = 0;
+	buttons[id].stableCount = 0;
+	buttons[id].sampling = 0;
+	buttonCount++;
+
+	return id;
+}
+
+/*
+ * Call from the EXTI interrupt of a button, masks the line and starts sampling
+ */
+void s4375116_reg_debounce_edge(int button) {
+
+	if (button < 0 || button >= buttonCount) {
+		return;
+	}
+
+	EXTI->IMR &= ~(0x01 << buttons[button].config.pin);	// ignore the bounces
+	buttons[button].changeCount = 0;
+	buttons[button].stableCount = 0;
+	buttons[button].sampling = 1;
+
+	if ((DEBOUNCE_TIMER->CR1 & TIM_CR1_CEN) == 0) {
+		DEBOUNCE_TIMER->CNT = 0;
+		DEBOUNCE_TIMER->CR1 |= TIM_CR1_CEN;		// Enable the counter
+	}
+}
+
+/*
+ * Interrupt handler (ISR) for the sampling timer
+ * Samples every button that is bouncing or held and stops once none are
+ */
+void TIM7_IRQHandler(void) {
+
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+	int active = 0;
+
+	NVIC_ClearPendingIRQ(DEBOUNCE_TIMER_IRQ);
+	DEBOUNCE_TIMER->SR &= ~TIM_SR_UIF;	// Clear the UIF Flag
+
+	for (int id = 0; id < buttonCount; id++) {
+		if (buttons[id].sampling) {
+			button_sample(id, &xHigherPriorityTaskWoken);
+			active |= buttons[id].sampling;
+		}
+	}
+
+	if (!active) {
+		DEBOUNCE_TIMER->CR1 &= ~TIM_CR1_CEN;	// Stop the counter
+	}
+
+	// Perform context switching, if required.
+	portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+}
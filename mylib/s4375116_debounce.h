@@ -0,0 +1,60 @@
+ /**
+ **************************************************************
+ * @file mylib/s4375116_debounce.h
+ * @author Sami Kaab - s4375116
+ * @date 19102026
+ * @brief Push button debouncing shared by every button
+ * The first edge of a button masks its EXTI line and starts a periodic timer that
+ * samples the pin, so contact bounce causes no further interrupts. A level held for
+ * DEBOUNCE_STABLE_SAMPLES samples is accepted and sent as a press or release event,
+ * a press held for DEBOUNCE_LONG_PRESS_MS also sends a long press event.
+ * Once the button is released and stable the EXTI line is unmasked again and the
+ * timer stops when no button is being sampled.
+ * REFERENCE: STM32F429 reference manual (RM0090) EXTI and basic timer chapters
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4375116_reg_debounce_add() - debounce a button whose EXTI line is already set up
+ * s4375116_reg_debounce_edge() - call from the EXTI interrupt of a button
+ ***************************************************************
+ */
+
+#ifndef S4375116_DEBOUNCE_H
+#define S4375116_DEBOUNCE_H
+
+#include <stdint.h>
+
+#define DEBOUNCE_TIMER				TIM7		// basic timer sampling the buttons
+#define DEBOUNCE_TIMER_IRQ			TIM7_IRQn
+#define DEBOUNCE_SAMPLE_MS			5			// time between samples
+#define DEBOUNCE_STABLE_SAMPLES		4			// samples a new level must hold to be accepted (20 ms)
+#define DEBOUNCE_LONG_PRESS_MS		1000		// press duration sending a long press event
+#define DEBOUNCE_MAX_BUTTONS		4
+
+// Event types
+#define DEBOUNCE_PRESS				0
+#define DEBOUNCE_RELEASE			1
+#define DEBOUNCE_LONG_PRESS			2
+
+// event sent when a button changes state
+struct debounceEvent {
+	uint8_t button;		// id returned by s4375116_reg_debounce_add()
+	uint8_t type;		// DEBOUNCE_PRESS, DEBOUNCE_RELEASE or DEBOUNCE_LONG_PRESS
+	uint32_t tick;		// HAL tick (ms) the level was accepted
+};
+typedef struct debounceEvent DebounceEvent;
+
+// button to debounce, fill in and pass to s4375116_reg_debounce_add()
+struct debounceButton {
+	GPIO_TypeDef *port;
+	uint8_t pin;
+	uint8_t activeLevel;	// pin level while pressed
+	QueueHandle_t queue;	// events are sent here if not NULL
+	void (*callback)(const DebounceEvent *event, BaseType_t *woken);	// called from the timer interrupt if not NULL
+};
+typedef struct debounceButton DebounceButton;
+
+int s4375116_reg_debounce_add(const DebounceButton *button);
+void s4375116_reg_debounce_edge(int button);
+
+#endif
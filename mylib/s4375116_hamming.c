@@ -4,6 +4,12 @@
  * @author Sami Kaab - s4375116 
  * @date 03042022
  * @brief hamming encoding and decoding lib functions
+ * Encoding and decoding are table lookups, the tables are worked out by the compiler
+ * from the parity equations so they are constant data in flash.
+ * The buffer functions work on a machine word of bytes at a time (4 on the board,
+ * 8 on a 64 bit host), each byte lane of the word is one block.
+ * The block codes (16,11), (32,26) and (72,64) are extended Hamming codes with far less
+ * overhead than the (8,4) byte code, their check bits are a table lookup per data byte.
  * REFERENCE: csse3010_mylib_lib_hamming.pdf, csse3010_stage3.pdf,
  * sourcelib/examples/getting-started/hamming/nucleo-f429/main.c
  ***************************************************************
@@ -12,189 +18,436 @@
  * s4375116_lib_hamming_byte_encode() - Hamming encode byte
  * s4375116_lib_hamming_byte_decode() - Hamming decode byte
  * s4375116_lib_hamming_parity_error() - Checks for parity error occured on hamming encoded byte
+ * s4375116_lib_hamming_decode() - Hamming decode a coded byte with the error status
+ * s4375116_lib_hamming_word_decode() - Hamming decode a coded word to a byte with the error status
+ * s4375116_lib_hamming_encode_buffer() - Hamming encode an array of bytes
+ * s4375116_lib_hamming_decode_buffer() - Hamming decode an array of coded bytes, counting errors
+ * s4375116_lib_hamming_block_encode() - check bits of a block of a higher rate code
+ * s4375116_lib_hamming_block_decode() - correct a block of a higher rate code with the error status
+ * s4375116_lib_hamming_72_encode_buffer() - (72,64) encode an array of bytes
+ * s4375116_lib_hamming_72_decode_buffer() - (72,64) decode an array of blocks, counting errors
  ***************************************************************
  */
 
-#include "board.h"
-#include "processor_hal.h"
-#include "debug_log.h"
+#include <stdint.h>
+#include <string.h>
+
 #include "s4375116_hamming.h"
 
-/**
-  * Implement Hamming Code + parity checking
-  * Hamming code is based on the following generator and parity check matrices
-  * G = [ 0 1 1 | 1 0 0 0 ;
-  *       1 0 1 | 0 1 0 0 ;
-  *       1 1 0 | 0 0 1 0 ;
-  *       1 1 1 | 0 0 0 1 ;
-  *
-  * y = x * G
-  *
-  *
-  * NOTE: !! is used to get 1 out of non zeros
-  * 
-  * Modified from getting-started/hamming example
-  */
-unsigned char hamming_hbyte_encode(unsigned char value) {
-
-	uint8_t d0, d1, d2, d3;
-	uint8_t p0 = 0, h0, h1, h2;
-	uint8_t z;
-	unsigned char out;
-
-	/* extract bits */
-	d0 = !!(value & 0x1);
-	d1 = !!(value & 0x2);
-	d2 = !!(value & 0x4);
-	d3 = !!(value & 0x8);
-
-	/* calculate hamming parity bits */
-	h0 = d1 ^ d2 ^ d3;
-	h1 = d0 ^ d2 ^ d3;
-  h2 = d0 ^ d1 ^ d3;
-
-	/* generate out byte without parity bit P0 */
-	out = (h0 << 1) | (h1 << 2) | (h2 << 3) |
-		(d0 << 4) | (d1 << 5) | (d2 << 6) | (d3 << 7);
-
-	/* calculate even parity bit */
-	for (z = 1; z<8; z++)
-		p0 = p0 ^ !!(out & (1 << z));
-
-	out |= p0;
-
-	return(out);
-}
+// word worked on by the buffer functions, loaded with memcpy: byte n of a buffer is lane n (little endian)
+#if UINTPTR_MAX > 0xFFFFFFFF
+typedef uint64_t HammingWord;
+#else
+typedef uint32_t HammingWord;
+#endif
+
+#define WORD_BYTES			(int) sizeof(HammingWord)
+#define LANE_LSB			((HammingWord) ~(HammingWord) 0 / 0xFF)	// 0x01 in every lane
+#define LANE_NIBBLE			(LANE_LSB * 0x0F)
+
+/*
+ * Hamming code is based on the following generator and parity check matrices
+ * G = [ 0 1 1 | 1 0 0 0 ;
+ *       1 0 1 | 0 1 0 0 ;
+ *       1 1 0 | 0 0 1 0 ;
+ *       1 1 1 | 0 0 0 1 ];
+ *
+ * H = [ 1 0 0 | 0 1 1 1 ;
+ *       0 1 0 | 1 0 1 1 ;
+ *       0 0 1 | 1 1 0 1 ];
+ *
+ * A coded byte is P0 H0 H1 H2 D0 D1 D2 D3 from bit 0 up, P0 makes the parity of the byte even.
+ */
+#define BIT(v, n)			(((v) >> (n)) & 0x01)
+#define PARITY8(v)			(BIT(v, 0) ^ BIT(v, 1) ^ BIT(v, 2) ^ BIT(v, 3) ^ BIT(v, 4) ^ BIT(v, 5) ^ BIT(v, 6) ^ BIT(v, 7))
+
+// nibble d to coded byte without P0 (y = x * G)
+#define CODE(d)				(((BIT(d, 1) ^ BIT(d, 2) ^ BIT(d, 3)) << 1) | ((BIT(d, 0) ^ BIT(d, 2) ^ BIT(d, 3)) << 2) | \
+							((BIT(d, 0) ^ BIT(d, 1) ^ BIT(d, 3)) << 3) | ((d) << 4))
+#define ENCODE(d)			(CODE(d) | PARITY8(CODE(d)))
+
+// syndrome of a coded byte (syn = H * y'), bit n is row n of H
+#define SYNDROME(v)			((BIT(v, 1) ^ BIT(v, 5) ^ BIT(v, 6) ^ BIT(v, 7)) | \
+							((BIT(v, 2) ^ BIT(v, 4) ^ BIT(v, 6) ^ BIT(v, 7)) << 1) | \
+							((BIT(v, 3) ^ BIT(v, 4) ^ BIT(v, 5) ^ BIT(v, 7)) << 2))
+
+// data bit flipped by a single error with the syndrome s, a column of H (0 for a hamming bit)
+#define FIX(s)				(((s) == 0x6) ? 0x1 : ((s) == 0x5) ? 0x2 : ((s) == 0x3) ? 0x4 : ((s) == 0x7) ? 0x8 : 0x0)
+
+// bit of the coded byte wrong for the syndrome s, 0 (P0) when only the parity fails
+#define ERROR_BIT(s)		(((s) == 0x1) ? 1 : ((s) == 0x2) ? 2 : ((s) == 0x4) ? 3 : ((s) == 0x6) ? 4 : \
+							((s) == 0x5) ? 5 : ((s) == 0x3) ? 6 : ((s) == 0x7) ? 7 : 0)
+
+// one bit wrong makes the parity odd, two leave it even with the syndrome set
+#define STATUS(v)			(PARITY8(v) ? HAMMING_CORRECTED : (SYNDROME(v) != 0) ? HAMMING_DOUBLE : HAMMING_CLEAN)
+#define FIXED(v)			(((v) >> 4) ^ FIX(SYNDROME(v)))
+#define DATA(v)				((STATUS(v) == HAMMING_DOUBLE) ? ((v) >> 4) : FIXED(v))
+
+// decode table entry
+#define DECODE_FIXED		0x000F	// data with the bit the syndrome points at flipped, as the byte decode always did
+#define DECODE_DATA			0x00F0	// data, left as received for a double error
+#define DECODE_STATUS		0x0300	// HammingStatus
+#define DECODE_BIT			0x7000	// bit of the coded byte corrected
+#define DECODE(v)			(FIXED(v) | (DATA(v) << 4) | (STATUS(v) << 8) | (ERROR_BIT(SYNDROME(v)) << 12))
+
+#define DECODE4(v)			DECODE(v), DECODE((v) + 1), DECODE((v) + 2), DECODE((v) + 3)
+#define DECODE16(v)			DECODE4(v), DECODE4((v) + 4), DECODE4((v) + 8), DECODE4((v) + 12)
+#define DECODE64(v)			DECODE16(v), DECODE16((v) + 16), DECODE16((v) + 32), DECODE16((v) + 48)
+
+static const uint8_t encodeTable[16] = {
+	ENCODE(0), ENCODE(1), ENCODE(2), ENCODE(3), ENCODE(4), ENCODE(5), ENCODE(6), ENCODE(7),
+	ENCODE(8), ENCODE(9), ENCODE(10), ENCODE(11), ENCODE(12), ENCODE(13), ENCODE(14), ENCODE(15),
+};
+
+static const uint16_t decodeTable[256] = {
+	DECODE64(0), DECODE64(64), DECODE64(128), DECODE64(192),
+};
+
+/*
+ * Block codes: data bit j sits at position BLOCK_POS(j) of a Hamming code, the positions that are
+ * not powers of two (3, 5, 6, 7, 9...). Check bit i of r is the parity of the data bits whose position
+ * has bit i set, check bit r makes the parity of the whole block even.
+ * The check bits are linear in the data, so they are the XOR of an entry per data byte, and a single
+ * wrong bit leaves the position it is at as the syndrome.
+ */
+#define BLOCK_POS(j)		((j) + 3 + ((j) >= 1) + ((j) >= 4) + ((j) >= 11) + ((j) >= 26) + ((j) >= 57))
+#define BLOCK_POWERS(p)		(((p) >= 1) + ((p) >= 2) + ((p) >= 4) + ((p) >= 8) + ((p) >= 16) + ((p) >= 32) + ((p) >= 64))
+#define BLOCK_INDEX(p)		((p) - 1 - BLOCK_POWERS(p))		// data bit at position p, not a power of two
+#define BLOCK_LOG2(p)		(((p) >= 2) + ((p) >= 4) + ((p) >= 8) + ((p) >= 16) + ((p) >= 32) + ((p) >= 64))	// p a power of two
+
+// check bits of data bit j, r hamming bits and the block parity
+#define BLOCK_COLUMN(j, r)	(BLOCK_POS(j) | ((1 ^ PARITY8(BLOCK_POS(j))) << (r)))
+#define BLOCK_TERM(r, b, v, t)	(BIT(v, t) ? BLOCK_COLUMN(8 * (b) + (t), r) : 0)
+#define BLOCK_ENCODE(r, b, v)	(BLOCK_TERM(r, b, v, 0) ^ BLOCK_TERM(r, b, v, 1) ^ BLOCK_TERM(r, b, v, 2) ^ BLOCK_TERM(r, b, v, 3) ^ \
+								BLOCK_TERM(r, b, v, 4) ^ BLOCK_TERM(r, b, v, 5) ^ BLOCK_TERM(r, b, v, 6) ^ BLOCK_TERM(r, b, v, 7))
+
+#define BLOCK_ENCODE4(r, b, v)		BLOCK_ENCODE(r, b, v), BLOCK_ENCODE(r, b, (v) + 1), BLOCK_ENCODE(r, b, (v) + 2), BLOCK_ENCODE(r, b, (v) + 3)
+#define BLOCK_ENCODE16(r, b, v)		BLOCK_ENCODE4(r, b, v), BLOCK_ENCODE4(r, b, (v) + 4), BLOCK_ENCODE4(r, b, (v) + 8), BLOCK_ENCODE4(r, b, (v) + 12)
+#define BLOCK_ENCODE64(r, b, v)		BLOCK_ENCODE16(r, b, v), BLOCK_ENCODE16(r, b, (v) + 16), BLOCK_ENCODE16(r, b, (v) + 32), BLOCK_ENCODE16(r, b, (v) + 48)
+#define BLOCK_ENCODE256(r, b)		{BLOCK_ENCODE64(r, b, 0), BLOCK_ENCODE64(r, b, 64), BLOCK_ENCODE64(r, b, 128), BLOCK_ENCODE64(r, b, 192)}
+
+/*
+ * Syndrome table entry for d, the check bits received XOR the check bits of the data received:
+ * HammingStatus << 8 and the bit of the block to flip (data bits first, then the r hamming bits, then the parity)
+ */
+#define BLOCK_S(d, r)		((d) & ((1 << (r)) - 1))
+#define BLOCK_ODD(d, r)		(BIT(d, r) ^ PARITY8(BLOCK_S(d, r)))	// parity of the whole block received
+#define BLOCK_SYNDROME(d, r, k)	(!BLOCK_ODD(d, r) ? ((BLOCK_S(d, r) == 0) ? HAMMING_CLEAN << 8 : HAMMING_DOUBLE << 8) : \
+								(BLOCK_S(d, r) == 0) ? (HAMMING_CORRECTED << 8) | ((k) + (r)) : \
+								((BLOCK_S(d, r) & (BLOCK_S(d, r) - 1)) == 0) ? (HAMMING_CORRECTED << 8) | ((k) + BLOCK_LOG2(BLOCK_S(d, r))) : \
+								(BLOCK_INDEX(BLOCK_S(d, r)) < (k)) ? (HAMMING_CORRECTED << 8) | BLOCK_INDEX(BLOCK_S(d, r)) : \
+								HAMMING_DOUBLE << 8)	// odd, but at a position past the block: three or more wrong
+#define BLOCK_SYNDROME_STATUS	0x0300
+#define BLOCK_SYNDROME_BIT		0x007F
+
+#define BLOCK_SYNDROME4(r, k, d)	BLOCK_SYNDROME(d, r, k), BLOCK_SYNDROME((d) + 1, r, k), BLOCK_SYNDROME((d) + 2, r, k), BLOCK_SYNDROME((d) + 3, r, k)
+#define BLOCK_SYNDROME16(r, k, d)	BLOCK_SYNDROME4(r, k, d), BLOCK_SYNDROME4(r, k, (d) + 4), BLOCK_SYNDROME4(r, k, (d) + 8), BLOCK_SYNDROME4(r, k, (d) + 12)
+#define BLOCK_SYNDROME64(r, k, d)	BLOCK_SYNDROME16(r, k, d), BLOCK_SYNDROME16(r, k, (d) + 16), BLOCK_SYNDROME16(r, k, (d) + 32), BLOCK_SYNDROME16(r, k, (d) + 48)
+
+static const uint8_t encode1611[2][256] = {BLOCK_ENCODE256(4, 0), BLOCK_ENCODE256(4, 1)};
+static const uint8_t encode3226[4][256] = {BLOCK_ENCODE256(5, 0), BLOCK_ENCODE256(5, 1), BLOCK_ENCODE256(5, 2), BLOCK_ENCODE256(5, 3)};
+static const uint8_t encode7264[8][256] = {BLOCK_ENCODE256(7, 0), BLOCK_ENCODE256(7, 1), BLOCK_ENCODE256(7, 2), BLOCK_ENCODE256(7, 3),
+		BLOCK_ENCODE256(7, 4), BLOCK_ENCODE256(7, 5), BLOCK_ENCODE256(7, 6), BLOCK_ENCODE256(7, 7)};
+
+static const uint16_t syndrome1611[32] = {BLOCK_SYNDROME16(4, 11, 0), BLOCK_SYNDROME16(4, 11, 16)};
+static const uint16_t syndrome3226[64] = {BLOCK_SYNDROME64(5, 26, 0)};
+static const uint16_t syndrome7264[256] = {BLOCK_SYNDROME64(7, 64, 0), BLOCK_SYNDROME64(7, 64, 64),
+		BLOCK_SYNDROME64(7, 64, 128), BLOCK_SYNDROME64(7, 64, 192)};
+
+// tables of a block code, by HAMMING_16_11...
+struct blockCode {
+	int dataBits;
+	int hammingBits;				// check bits without the block parity
+	const uint8_t (*encode)[256];	// check bits of each data byte
+	const uint16_t *syndrome;
+};
+
+static const struct blockCode blockCodes[] = {
+	{11, 4, encode1611, syndrome1611},
+	{26, 5, encode3226, syndrome3226},
+	{64, 7, encode7264, syndrome7264},
+};
 
 /*
  * Implement Hamming Code on a full byte of input
- * This means that 16-bits out output is needed
- * 
- * Modified from getting-started/hamming example
+ * This means that 16-bits out output is needed, D0..D3 in the low byte
  */
 unsigned short s4375116_lib_hamming_byte_encode(unsigned char value) {
+	return encodeTable[value & 0x0F] | (encodeTable[value >> 4] << 8);
+}
+
+/*
+ * Decode a hamming coded byte to its 4 data bits, a single bit error is corrected
+ */
+unsigned char s4375116_lib_hamming_byte_decode(unsigned char value) {
+	return decodeTable[value] & DECODE_FIXED;
+}
 
-	unsigned short out;
+/**
+ * @brief Takes in the hamming coded byte, perfoms a parity check and returns 1 if it fails.
+ * 
+ * @param value the hamming coded 8bit value 
+ * @return int 0 if there is an even number of ones and 1 if there is an odd number of ones
+ */
+int s4375116_lib_hamming_parity_error(unsigned char value) {
+	return (decodeTable[value] & DECODE_STATUS) == (HAMMING_CORRECTED << 8);
+}
 
-	/* first encode D0..D3 (first 4 bits),
-	 * then D4..D7 (second 4 bits).
-	 */
-	out = hamming_hbyte_encode(value & 0xF) |
-		(hamming_hbyte_encode(value >> 4) << 8);
+/*
+ * Decode a hamming coded byte with single error correction and double error detection, in one lookup.
+ * data returns the 4 data bits, corrected for a single error and as received for a double error.
+ * bit (may be NULL) returns the bit of the coded byte that was corrected, -1 if none
+ */
+HammingStatus s4375116_lib_hamming_decode(unsigned char value, unsigned char *data, int *bit) {
 
-	return(out);
+	uint16_t entry = decodeTable[value];
+	HammingStatus status = (entry & DECODE_STATUS) >> 8;
 
+	*data = (entry & DECODE_DATA) >> 4;
+	if (bit != NULL) {
+		*bit = (status == HAMMING_CORRECTED) ? (entry & DECODE_BIT) >> 12 : -1;
+	}
+	return status;
 }
 
+/*
+ * Decode a coded word (as from s4375116_lib_hamming_byte_encode()) back to its byte,
+ * the status is the worst of the two halves
+ */
+HammingStatus s4375116_lib_hamming_word_decode(unsigned short value, unsigned char *data) {
+
+	uint16_t lo = decodeTable[value & 0xFF];
+	uint16_t hi = decodeTable[value >> 8];
+
+	*data = ((lo & DECODE_DATA) >> 4) | (hi & DECODE_DATA);
+	return ((lo & DECODE_STATUS) > (hi & DECODE_STATUS) ? (lo & DECODE_STATUS) : (hi & DECODE_STATUS)) >> 8;
+}
 
 /**
- * @brief Returns the location of the error in the hamming
- * encoded message base on its syndrom
- * 
- * @param syn 
- * @return unsigned char 
- */
-unsigned char check_error_location(unsigned char syn) {
-
-    switch (syn) {
-
-      case 0b110:
-      
-          return 1;
-          break;
-      
-      case 0b101:
-      
-          return 2;
-          break;
-      
-      case 0b011:
-      
-          return 3;
-          break;
-      
-      case 0b111:
-      
-          return 4;
-          break;
-      
-      default:
-      
-          return 0;
-          break;
-    }
+ * @brief Sum of the lanes of a word holding 0 or 1 in each lane
+ *
+ */
+static inline int lane_count(HammingWord flags) {
+	return (flags * LANE_LSB) >> (8 * (WORD_BYTES - 1));	// every lane added into the top one
 }
 
 /**
-  * Implement Hamming Code + parity checking
-  * Hamming code is based on the following generator and parity check matrices
-  *
-  * hence H =
-  * [ 1 0 0 | 0 1 1 1 ;
-  *   0 1 0 | 1 0 1 1 ;
-  *   0 0 1 | 1 1 0 1 ];
-  *
-  * syn = H * y'
-  *
-  * NOTE: !! is used to get 1 out of non zeros
-  */
-unsigned char s4375116_lib_hamming_byte_decode(unsigned char value) {
+ * @brief Encode a nibble in every lane, the same as ENCODE() on each lane
+ *
+ * @param d nibble in bits 0..3 of every lane
+ */
+static inline HammingWord encode_lanes(HammingWord d) {
 
-  uint8_t d0, d1, d2, d3;
-	uint8_t h0, h1, h2;
-  uint8_t s0, s1, s2;
-	unsigned char syn, out, errLoc;
-
-	/* extract data bits */
-	d0 = !!(value & 0x10);
-	d1 = !!(value & 0x20);
-	d2 = !!(value & 0x40);
-	d3 = !!(value & 0x80);
-
-  /* extract hamming bits */
-	h0 = !!(value & 0x2);
-	h1 = !!(value & 0x4);
-	h2 = !!(value & 0x8);
-
-	/* calculate syndrom */
-	s0 = h0 ^ d1 ^ d2 ^ d3;
-	s1 = h1 ^ d0 ^ d2 ^ d3;
-	s2 = h2 ^ d0 ^ d1 ^ d3;
-
-  out = (d0 << 0) | (d1 << 1) | (d2 << 2) | (d3 << 3);
-	
-	syn = (s0 << 0) | (s1 << 1) | (s2 << 2);
-
-  // debug_log("syn:\t");
-  // print_binary(syn, 3);
-  // get position of error from computed syn
-  errLoc = check_error_location(syn);
-  // debug_log("error position:\t%d\n\r", errLoc-1);
-  if (errLoc) {// error was detected
-    // correct error by flipping appropriate bit
-    out = (out ^ (0x1 << (errLoc-1)));
-  }
-
-	return(out);
+	HammingWord h0 = ((d >> 1) ^ (d >> 2) ^ (d >> 3)) & LANE_LSB;
+	HammingWord h1 = (d ^ (d >> 2) ^ (d >> 3)) & LANE_LSB;
+	HammingWord h2 = (d ^ (d >> 1) ^ (d >> 3)) & LANE_LSB;
+	HammingWord p0 = (h0 ^ h1 ^ h2 ^ d ^ (d >> 1) ^ (d >> 2) ^ (d >> 3)) & LANE_LSB;
 
+	return (d << 4) | (h2 << 3) | (h1 << 2) | (h0 << 1) | p0;
+}
+
+/*
+ * Hamming encode len bytes into 2 * len coded bytes, each byte as s4375116_lib_hamming_byte_encode()
+ * (D0..D3 first). Returns the number of coded bytes
+ */
+int s4375116_lib_hamming_encode_buffer(const uint8_t *in, uint8_t *out, int len) {
+
+	HammingWord word;
+	HammingWord lo;
+	HammingWord hi;
+	int i;
+
+	for (i = 0; i + WORD_BYTES <= len; i += WORD_BYTES) {
+		memcpy(&word, in + i, WORD_BYTES);
+		lo = encode_lanes(word & LANE_NIBBLE);
+		hi = encode_lanes((word >> 4) & LANE_NIBBLE);
+		for (int b = 0; b < WORD_BYTES; b++) {
+			out[2 * (i + b)] = lo >> (8 * b);
+			out[2 * (i + b) + 1] = hi >> (8 * b);
+		}
+	}
+	for (; i < len; i++) {
+		out[2 * i] = encodeTable[in[i] & 0x0F];
+		out[2 * i + 1] = encodeTable[in[i] >> 4];
+	}
+	return 2 * len;
+}
+
+/*
+ * Hamming decode len coded bytes (an even number) into len / 2 bytes, each pair as two calls of
+ * s4375116_lib_hamming_byte_decode(). counts (may be NULL) returns the blocks corrected and the
+ * blocks that could not be. Returns the number of bytes decoded, or -1 if len is odd
+ */
+int s4375116_lib_hamming_decode_buffer(const uint8_t *in, uint8_t *out, int len, HammingCounts *counts) {
+
+	HammingWord word;
+	HammingWord s0, s1, s2;
+	HammingWord parity;
+	HammingWord data;
+	unsigned long corrected = 0;
+	unsigned long uncorrectable = 0;
+	uint16_t entry;
+	int i;
+
+	if ((len % 2) != 0) {
+		return -1;
+	}
+
+	for (i = 0; i + WORD_BYTES <= len; i += WORD_BYTES) {
+		memcpy(&word, in + i, WORD_BYTES);
+
+		// syndrome and parity of every lane, shifts only bring other lanes into bits that are masked off
+		s0 = ((word >> 1) ^ (word >> 5) ^ (word >> 6) ^ (word >> 7)) & LANE_LSB;
+		s1 = ((word >> 2) ^ (word >> 4) ^ (word >> 6) ^ (word >> 7)) & LANE_LSB;
+		s2 = ((word >> 3) ^ (word >> 4) ^ (word >> 5) ^ (word >> 7)) & LANE_LSB;
+		parity = word ^ (word >> 4);
+		parity ^= parity >> 2;
+		parity = (parity ^ (parity >> 1)) & LANE_LSB;
+
+		// flip the data bit the syndrome points at, as FIX()
+		data = ((word >> 4) & LANE_NIBBLE) ^ ((s0 ^ LANE_LSB) & s1 & s2) ^ ((s0 & (s1 ^ LANE_LSB) & s2) << 1) ^
+				((s0 & s1 & (s2 ^ LANE_LSB)) << 2) ^ ((s0 & s1 & s2) << 3);
+
+		corrected += lane_count(parity);
+		uncorrectable += lane_count((s0 | s1 | s2) & (parity ^ LANE_LSB));
+
+		// join the nibbles of each pair of lanes
+		data |= data >> 4;
+		for (int b = 0; b < WORD_BYTES / 2; b++) {
+			out[i / 2 + b] = data >> (16 * b);
+		}
+	}
+	for (; i < len; i += 2) {
+		out[i / 2] = (decodeTable[in[i]] & DECODE_FIXED) | ((decodeTable[in[i + 1]] & DECODE_FIXED) << 4);
+		for (int b = 0; b < 2; b++) {
+			entry = decodeTable[in[i + b]] & DECODE_STATUS;
+			corrected += entry == (HAMMING_CORRECTED << 8);
+			uncorrectable += entry == (HAMMING_DOUBLE << 8);
+		}
+	}
+
+	if (counts != NULL) {
+		counts->corrected = corrected;
+		counts->uncorrectable = uncorrectable;
+	}
+	return len / 2;
 }
 
 /**
- * @brief Takes in the hamming coded byte, perfoms a parity check and returns 1 if it fails.
- * 
- * @param value the hamming coded 8bit value 
- * @return int 0 if there is an even number of ones and 1 if there is an odd number of ones
+ * @brief Check bits of the data of a block, the data has no bits above the data bits
+ *
  */
-int s4375116_lib_hamming_parity_error(unsigned char value) {
+static inline unsigned char block_checks(const struct blockCode *block, uint64_t data) {
+
+	unsigned char checks = 0;
 
-  uint8_t p0 = 0, z;
-  /* calculate even parity bit */
-	for (z = 0; z<8; z++) {
-		p0 = p0 ^ !!(value & (1 << z));
-  }
-  
-  return p0;
+	for (int b = 0; b < (block->dataBits + 7) / 8; b++) {
+		checks ^= block->encode[b][(data >> (8 * b)) & 0xFF];
+	}
+	return checks;
 }
 
+/*
+ * Check bits of a block of the code (HAMMING_16_11, HAMMING_32_26 or HAMMING_72_64),
+ * the data bits above the size of the block are ignored
+ */
+unsigned char s4375116_lib_hamming_block_encode(int code, uint64_t data) {
 
+	const struct blockCode *block = &blockCodes[code];
 
+	return block_checks(block, data & (~(uint64_t) 0 >> (64 - block->dataBits)));
+}
+
+/*
+ * Decode a block of the code with single error correction and double error detection.
+ * data is corrected in place for a single error and left as received for a double error.
+ * bit (may be NULL) returns the bit of the block that was corrected, -1 if none:
+ * data bits first, then the check bits from bit 0
+ */
+HammingStatus s4375116_lib_hamming_block_decode(int code, uint64_t *data, unsigned char check, int *bit) {
+
+	const struct blockCode *block = &blockCodes[code];
+	uint16_t entry;
+	int wrong;
+
+	*data &= ~(uint64_t) 0 >> (64 - block->dataBits);
+	entry = block->syndrome[(block_checks(block, *data) ^ check) & ((2 << block->hammingBits) - 1)];
+	wrong = entry & BLOCK_SYNDROME_BIT;
+
+	if ((entry & BLOCK_SYNDROME_STATUS) != (HAMMING_CORRECTED << 8)) {
+		wrong = -1;
+	} else if (wrong < block->dataBits) {
+		*data ^= (uint64_t) 1 << wrong;
+	}
+	if (bit != NULL) {
+		*bit = wrong;
+	}
+	return (entry & BLOCK_SYNDROME_STATUS) >> 8;
+}
+
+/*
+ * (72,64) encode len bytes, each 8 bytes become a block of the 8 bytes and their check byte.
+ * The last block is padded with zeros. Returns the number of bytes written, 9 for every 8 started
+ */
+int s4375116_lib_hamming_72_encode_buffer(const uint8_t *in, uint8_t *out, int len) {
+
+	unsigned char checks;
+	uint8_t byte;
+	int written = 0;
+
+	for (int i = 0; i < len; i += 8) {
+		checks = 0;
+		for (int b = 0; b < 8; b++) {
+			byte = (i + b < len) ? in[i + b] : 0;
+			checks ^= encode7264[b][byte];
+			out[written++] = byte;
+		}
+		out[written++] = checks;
+	}
+	return written;
+}
+
+/*
+ * (72,64) decode len bytes of blocks (a multiple of 9) into 8 bytes per block.
+ * counts (may be NULL) returns the blocks corrected and the blocks that could not be.
+ * Returns the number of bytes decoded, or -1 if len is not a number of blocks
+ */
+int s4375116_lib_hamming_72_decode_buffer(const uint8_t *in, uint8_t *out, int len, HammingCounts *counts) {
+
+	unsigned long corrected = 0;
+	unsigned long uncorrectable = 0;
+	unsigned char checks;
+	uint16_t entry;
+	int written = 0;
+	int wrong;
+
+	if ((len % 9) != 0) {
+		return -1;
+	}
+
+	for (int i = 0; i < len; i += 9) {
+		checks = in[i + 8];
+		for (int b = 0; b < 8; b++) {
+			checks ^= encode7264[b][in[i + b]];
+			out[written + b] = in[i + b];
+		}
+
+		entry = syndrome7264[checks];
+		wrong = entry & BLOCK_SYNDROME_BIT;
+		if ((entry & BLOCK_SYNDROME_STATUS) == (HAMMING_CORRECTED << 8)) {
+			corrected++;
+			if (wrong < 64) {
+				out[written + wrong / 8] ^= 1 << (wrong % 8);
+			}
+		} else if ((entry & BLOCK_SYNDROME_STATUS) == (HAMMING_DOUBLE << 8)) {
+			uncorrectable++;
+		}
+		written += 8;
+	}
+
+	if (counts != NULL) {
+		counts->corrected = corrected;
+		counts->uncorrectable = uncorrectable;
+	}
+	return written;
+}
@@ -4,6 +4,12 @@
  * @author Sami Kaab - s4375116 
  * @date 03042022
  * @brief hamming encoding and decoding lib functions
+ * Encoding and decoding are table lookups, the tables are worked out by the compiler
+ * from the parity equations so they are constant data in flash.
+ * The buffer functions work on a machine word of bytes at a time (4 on the board,
+ * 8 on a 64 bit host), each byte lane of the word is one block.
+ * The block codes (16,11), (32,26) and (72,64) are extended Hamming codes with far less
+ * overhead than the (8,4) byte code, their check bits are a table lookup per data byte.
  * REFERENCE: csse3010_mylib_lib_hamming.pdf, csse3010_stage3.pdf,
  * sourcelib/examples/getting-started/hamming/nucleo-f429/main.c
  ***************************************************************
@@ -12,14 +18,52 @@
  * s4375116_lib_hamming_byte_encode() - Hamming encode byte
  * s4375116_lib_hamming_byte_decode() - Hamming decode byte
  * s4375116_lib_hamming_parity_error() - Checks for parity error occured on hamming encoded byte
+ * s4375116_lib_hamming_decode() - Hamming decode a coded byte with the error status
+ * s4375116_lib_hamming_word_decode() - Hamming decode a coded word to a byte with the error status
+ * s4375116_lib_hamming_encode_buffer() - Hamming encode an array of bytes
+ * s4375116_lib_hamming_decode_buffer() - Hamming decode an array of coded bytes, counting errors
+ * s4375116_lib_hamming_block_encode() - check bits of a block of a higher rate code
+ * s4375116_lib_hamming_block_decode() - correct a block of a higher rate code with the error status
+ * s4375116_lib_hamming_72_encode_buffer() - (72,64) encode an array of bytes
+ * s4375116_lib_hamming_72_decode_buffer() - (72,64) decode an array of blocks, counting errors
  ***************************************************************
  */
 
 #ifndef S4375116_HAMMING_H
-#define s4375116_HAMMING_H
+#define S4375116_HAMMING_H
+
+#include <stdint.h>
+
+// Block codes, single error correction and double error detection like the byte code
+#define HAMMING_16_11	0	// 11 data bits, 5 check bits (45% overhead)
+#define HAMMING_32_26	1	// 26 data bits, 6 check bits (23%)
+#define HAMMING_72_64	2	// 64 data bits, 8 check bits (12.5%)
+
+// result of decoding a coded byte, in order of severity
+enum hammingStatus {
+	HAMMING_CLEAN = 0,		// no error
+	HAMMING_CORRECTED = 1,	// one bit wrong (parity fails), corrected
+	HAMMING_DOUBLE = 2		// two bits wrong (syndrome set, parity passes), detected but not corrected
+};
+typedef enum hammingStatus HammingStatus;
+
+// blocks (coded bytes) with errors found by s4375116_lib_hamming_decode_buffer()
+struct hammingCounts {
+	unsigned long corrected;		// one bit wrong (parity fails), data corrected
+	unsigned long uncorrectable;	// two bits wrong (syndrome set, parity passes), data not to be trusted
+};
+typedef struct hammingCounts HammingCounts;
 
 unsigned short s4375116_lib_hamming_byte_encode(unsigned char value);
 unsigned char s4375116_lib_hamming_byte_decode(unsigned char value);
 int s4375116_lib_hamming_parity_error(unsigned char value);
+HammingStatus s4375116_lib_hamming_decode(unsigned char value, unsigned char *data, int *bit);
+HammingStatus s4375116_lib_hamming_word_decode(unsigned short value, unsigned char *data);
+int s4375116_lib_hamming_encode_buffer(const uint8_t *in, uint8_t *out, int len);
+int s4375116_lib_hamming_decode_buffer(const uint8_t *in, uint8_t *out, int len, HammingCounts *counts);
+unsigned char s4375116_lib_hamming_block_encode(int code, uint64_t data);
+HammingStatus s4375116_lib_hamming_block_decode(int code, uint64_t *data, unsigned char check, int *bit);
+int s4375116_lib_hamming_72_encode_buffer(const uint8_t *in, uint8_t *out, int len);
+int s4375116_lib_hamming_72_decode_buffer(const uint8_t *in, uint8_t *out, int len, HammingCounts *counts);
         
-#endif
\ No newline at end of file
+#endif
@@ -13,11 +13,18 @@
  * s4375116_reg_joystick_press_get() - Returns the value of the Joystick pushbutton press
  * s4375116_reg_joystick_press_reset() - Reset the Joystick event counter value to 0
  * s4375116_reg_joystick_init() - Initialise pins as ADC inputs from the joystick
- * s4375116_joystick_readxy() - Read ADC value from one of the joystick axes (x or y)
+ * s4375116_joystick_read() - Latest averaged ADC value of one of the joystick axes (x or y)
+ * s4375116_reg_joystick_awd_window() - Wake the joystick task when an axis leaves a window
+ * s4375116_joystick_normalise() - Convert an adc value of an axis to calibrated units
+ * s4375116_joystick_cal_start() - Ask the joystick task to run a calibration sweep
+ * s4375116_joystick_cal_get() - Calibration in use
+ * s4375116_joystick_set_log() - Set the function printing the calibration messages
  * s4375116_tsk_joystick_init() - Create Joystick Task
  *************************************************************** 
  */
 
+#include <stdlib.h>
+
 #include "board.h"
 #include "processor_hal.h"
 #include "debug_log.h"
@@ -30,20 +37,57 @@
 
 #include "s4375116_joystick.h"
 #include "s4375116_CAG_joystick.h"
+#include "s4375116_debounce.h"
 
 
 /* The number of times the joystick push button has been pressed */
 static int joystick_press_counter;
-/* The last time (ms) a rising edge was detected */
-uint32_t previous_rising_edge_trigger = 0;
-/* The last time (ms) a rising edge was detected */
-uint32_t previous_falling_edge_trigger = 0;
+/* pairs of X (low half word) and Y (high half word) results written by DMA */
+static volatile uint32_t adcSamples[JOYSTICK_ADC_SAMPLES];
+/* joystick task, woken by the analog watchdogs */
+static TaskHandle_t joystickTaskHandle = NULL;
+/* debounced joystick pushbutton */
+static int joystick_pb_button = -1;
+/* calibration in use, full adc range until the joystick task loads or measures one */
+static JoystickCal joystickCal = {{2048, 2048}, {0, 0}, {4095, 4095}};
+/* prints the calibration messages, debug_log until the application owns the uart */
+static int (*joystickLog)(const char *fmt, ...) = NULL;
+
+#define JOYSTICK_LOG(...)	do { \
+		if (joystickLog != NULL) { \
+			joystickLog(__VA_ARGS__); \
+		} else { \
+			debug_log(__VA_ARGS__); \
+		} \
+	} while (0)
+
+/*
+ * Debounced joystick push button event (timer interrupt)
+ * A press increments the Joystick pushbutton event counter by 1 and gives the pushbutton semaphores
+ */
+void joystick_pb_event(const DebounceEvent *event, BaseType_t *woken) {
+
+	if (event->type != DEBOUNCE_PRESS) {
+		return;
+	}
+
+	joystick_press_counter++;
+
+	if (LTpbSemaphore != NULL) {	// Check if semaphore exists 
+		xSemaphoreGiveFromISR( LTpbSemaphore, woken );		// Give PB Semaphore from ISR
+	}
+	if (RTpbSemaphore != NULL) {	// Check if semaphore exists 
+		xSemaphoreGiveFromISR( RTpbSemaphore, woken );		// Give PB Semaphore from ISR
+	}
+}
 
 /* 
  * Initialise GPIO pin A0 (PA3) as a rising and falling edge interrupt
  */
 void s4375116_reg_joystick_pb_init(void) {
 
+	DebounceButton button;
+
 	BRD_debuguart_init();  //Initialise UART for debug log output
 
     // Enable GPIOA Clock
@@ -68,50 +112,22 @@ void s4375116_reg_joystick_pb_init(void) {
 	//Enable priority (10) and interrupt callback. Do not set a priority lower than 5.
 	HAL_NVIC_SetPriority(EXTI3_IRQn, 10, 0);
 	HAL_NVIC_EnableIRQ(EXTI3_IRQn);
+
+	// pressed pulls PA3 low, events also go to joystickPbEventQueue when it has been created
+	button.port = GPIOA;
+	button.pin = 3;
+	button.activeLevel = 0;
+	button.queue = joystickPbEventQueue;
+	button.callback = joystick_pb_event;
+	joystick_pb_button = s4375116_reg_debounce_add(&button);
 }
 
 /*
- * Joystick Push Button callback
- * Increments the value of the Joystick pushbutton event counter by 1
+ * Joystick Push Button callback, the first edge hands the button to the debouncer
  */
 void s4375116_reg_joystick_pb_isr(void) {
 
-	BaseType_t xHigherPriorityTaskWoken; //RTOS related
-	
-	// Check that PA3 is high (rising edge)
-	if ((GPIOA->IDR & (0x0001 << 3))) {
-
-		previous_rising_edge_trigger = HAL_GetTick();
-		
-		// debug_log("rise %d\r\n", previous_falling_edge_trigger);
-		// debug_log("dt %d\r\n", previous_rising_edge_trigger-previous_falling_edge_trigger);
-		
-		// Check that the push button has been pressed for long enough
-		if (previous_falling_edge_trigger-previous_rising_edge_trigger > 110) {
-
-			joystick_press_counter++;
-
-			/* -----------	RTOS : give semaphore	-----------------------*/
-			// Is it time for another Task() to run?
-			xHigherPriorityTaskWoken = pdFALSE;
-
-			if (LTpbSemaphore != NULL) {	// Check if semaphore exists 
-				xSemaphoreGiveFromISR( LTpbSemaphore, &xHigherPriorityTaskWoken );		// Give PB Semaphore from ISR
-			}
-			if (RTpbSemaphore != NULL) {	// Check if semaphore exists 
-				xSemaphoreGiveFromISR( RTpbSemaphore, &xHigherPriorityTaskWoken );		// Give PB Semaphore from ISR
-			}
-
-			// Perform context switching, if required.
-			portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
-
-		}
-
-	} else { // PA3 is low (falling edge)
-
-		previous_falling_edge_trigger = HAL_GetTick();
-		// debug_log("fall %d\r\n", previous_falling_edge_trigger);	
-	}
+	s4375116_reg_debounce_edge(joystick_pb_button);
 }
 
 /*
@@ -149,7 +165,9 @@ void EXTI3_IRQHandler(void) {
 }
 
 /*
- *  Initialise pins A1(PC0) and A2(PC3) to be ADC inputs 
+ *  Initialise pins A1(PC0) and A2(PC3) to be ADC inputs sampled continuously.
+ *  TIM3 triggers ADC1 (X, PC3) and ADC2 (Y, PC0) together in dual regular simultaneous mode,
+ *  DMA2 Stream 0 copies each pair of results from the common data register into a circular buffer.
  */
 void s4375116_reg_joystick_init(void) {
 	
@@ -164,92 +182,274 @@ void s4375116_reg_joystick_init(void) {
 
 	GPIOC->PUPDR &= ~((0x03 << (3 * 2)) | (0x03 << (0 * 2)));	//Clear bits for no push/pull
 
-	// Set up ADC for A2
-	__ADC1_CLK_ENABLE();						//Enable ADC1 clock
-
-	AdcHandleX.Instance = (ADC_TypeDef *)(ADC1_BASE);						//Use ADC1 (For PC3)
-	AdcHandleX.Init.ClockPrescaler        = ADC_CLOCKPRESCALER_PCLK_DIV2;	//Set clock prescaler
-	AdcHandleX.Init.Resolution            = ADC_RESOLUTION12b;				//Set 12-bit data resolution
-	AdcHandleX.Init.ScanConvMode          = DISABLE;
-	AdcHandleX.Init.ContinuousConvMode    = DISABLE;
-	AdcHandleX.Init.DiscontinuousConvMode = DISABLE;
-	AdcHandleX.Init.NbrOfDiscConversion   = 0;
-	AdcHandleX.Init.ExternalTrigConvEdge  = ADC_EXTERNALTRIGCONVEDGE_NONE;	//No Trigger
-	AdcHandleX.Init.ExternalTrigConv      = ADC_EXTERNALTRIGCONV_T1_CC1;		//No Trigger
-	AdcHandleX.Init.DataAlign             = ADC_DATAALIGN_RIGHT;				//Right align data
-	AdcHandleX.Init.NbrOfConversion       = 1;
-	AdcHandleX.Init.DMAContinuousRequests = DISABLE;
-	AdcHandleX.Init.EOCSelection          = DISABLE;
-
-	HAL_ADC_Init(&AdcHandleX);		//Initialise ADC
-
-	// Configure ADC Channel
-	AdcChanConfigX.Channel = ADC_CHANNEL_13;					//PC3 has Analog Channel 1 connected
-	AdcChanConfigX.Rank         = 1;
-	AdcChanConfigX.SamplingTime = ADC_SAMPLETIME_3CYCLES;
-	AdcChanConfigX.Offset       = 0;
-
-	HAL_ADC_ConfigChannel(&AdcHandleX, &AdcChanConfigX);		//Initialise ADC Channel
+	__ADC1_CLK_ENABLE();	//Enable ADC1 clock
+	__ADC2_CLK_ENABLE();	//Enable ADC2 clock
+	__DMA2_CLK_ENABLE();	//Enable DMA2 clock
+	__TIM3_CLK_ENABLE();	//Enable TIM3 clock
+
+	// DMA2 Stream 0 channel 0 (ADC1): common data register -> adcSamples, 32 bits per pair, circular
+	JOYSTICK_ADC_DMA->CR &= ~DMA_SxCR_EN;
+	while (JOYSTICK_ADC_DMA->CR & DMA_SxCR_EN);	// wait for the stream to stop
+	JOYSTICK_ADC_DMA->PAR = (uint32_t) &ADC->CDR;
+	JOYSTICK_ADC_DMA->M0AR = (uint32_t) adcSamples;
+	JOYSTICK_ADC_DMA->NDTR = JOYSTICK_ADC_SAMPLES;
+	JOYSTICK_ADC_DMA->CR = DMA_SxCR_MSIZE_1 | DMA_SxCR_PSIZE_1 | DMA_SxCR_MINC | DMA_SxCR_CIRC | DMA_SxCR_PL_0;
+	JOYSTICK_ADC_DMA->FCR &= ~DMA_SxFCR_DMDIS;	// direct mode
+	JOYSTICK_ADC_DMA->CR |= DMA_SxCR_EN;
+
+	// ADC clock PCLK2/4, dual regular simultaneous mode, DMA mode 2 (ADC2 << 16 | ADC1) with continuous requests
+	ADC->CCR &= ~(ADC_CCR_ADCPRE | ADC_CCR_MULTI | ADC_CCR_DMA | ADC_CCR_DDS);
+	ADC->CCR |= ADC_CCR_ADCPRE_0 | (ADC_CCR_MULTI_2 | ADC_CCR_MULTI_1) | ADC_CCR_DMA_1 | ADC_CCR_DDS;
+
+	// ADC1 (master): X axis, 12 bits, one conversion per TIM3 update
+	ADC1->CR1 &= ~(ADC_CR1_RES | ADC_CR1_SCAN);
+	ADC1->CR2 &= ~(ADC_CR2_CONT | ADC_CR2_ALIGN | ADC_CR2_EXTEN | ADC_CR2_EXTSEL);
+	ADC1->CR2 |= ADC_CR2_EXTEN_0 | ADC_CR2_EXTSEL_3;	// rising edge of TIM3 TRGO
+	ADC1->SQR1 &= ~ADC_SQR1_L;							// 1 conversion
+	ADC1->SQR3 = 13;									// PC3 is channel 13
+	ADC1->SMPR1 &= ~ADC_SMPR1_SMP13;
+	ADC1->SMPR1 |= ADC_SMPR1_SMP13_2;					// 84 cycles
+
+	// ADC2 (slave): Y axis, started by ADC1
+	ADC2->CR1 &= ~(ADC_CR1_RES | ADC_CR1_SCAN);
+	ADC2->CR2 &= ~(ADC_CR2_CONT | ADC_CR2_ALIGN | ADC_CR2_EXTEN);
+	ADC2->SQR1 &= ~ADC_SQR1_L;
+	ADC2->SQR3 = 10;									// PC0 is channel 10
+	ADC2->SMPR1 &= ~ADC_SMPR1_SMP10;
+	ADC2->SMPR1 |= ADC_SMPR1_SMP10_2;
+
+	ADC1->CR2 |= ADC_CR2_ADON;
+	ADC2->CR2 |= ADC_CR2_ADON;
+
+	// TIM3 update event triggers the conversions at JOYSTICK_SAMPLE_HZ
+	TIM3->PSC = ((SystemCoreClock / 2) / 1000000) - 1;	// 1MHz counter
+	TIM3->ARR = (1000000 / JOYSTICK_SAMPLE_HZ) - 1;
+	TIM3->CR2 &= ~TIM_CR2_MMS;
+	TIM3->CR2 |= TIM_CR2_MMS_1;							// TRGO on update
+	TIM3->CR1 |= TIM_CR1_CEN;							// Enable the counter
+
+	// Analog watchdogs on the single channel of each ADC, armed by s4375116_reg_joystick_awd_window()
+	ADC1->CR1 &= ~(ADC_CR1_AWDCH | ADC_CR1_AWDIE);
+	ADC1->CR1 |= ADC_CR1_AWDEN | ADC_CR1_AWDSGL | 13;
+	ADC2->CR1 &= ~(ADC_CR1_AWDCH | ADC_CR1_AWDIE);
+	ADC2->CR1 |= ADC_CR1_AWDEN | ADC_CR1_AWDSGL | 10;
 
-	
-	// Set up ADC for A1(PC0)
-	__ADC2_CLK_ENABLE();						//Enable ADC1 clock
-
-	AdcHandleY.Instance = (ADC_TypeDef *)(ADC2_BASE);						//Use ADC2 (For PC0)
-	AdcHandleY.Init.ClockPrescaler        = ADC_CLOCKPRESCALER_PCLK_DIV2;	//Set clock prescaler
-	AdcHandleY.Init.Resolution            = ADC_RESOLUTION12b;				//Set 12-bit data resolution
-	AdcHandleY.Init.ScanConvMode          = DISABLE;
-	AdcHandleY.Init.ContinuousConvMode    = DISABLE;
-	AdcHandleY.Init.DiscontinuousConvMode = DISABLE;
-	AdcHandleY.Init.NbrOfDiscConversion   = 0;
-	AdcHandleY.Init.ExternalTrigConvEdge  = ADC_EXTERNALTRIGCONVEDGE_NONE;	//No Trigger
-	AdcHandleY.Init.ExternalTrigConv      = ADC_EXTERNALTRIGCONV_T1_CC1;		//No Trigger
-	AdcHandleY.Init.DataAlign             = ADC_DATAALIGN_RIGHT;				//Right align data
-	AdcHandleY.Init.NbrOfConversion       = 1;
-	AdcHandleY.Init.DMAContinuousRequests = DISABLE;
-	AdcHandleY.Init.EOCSelection          = DISABLE;
-
-	HAL_ADC_Init(&AdcHandleY);		//Initialise ADC
-
-	// Configure ADC Channel
-	AdcChanConfigY.Channel = ADC_CHANNEL_10;					//PC0 has Analog Channel 1 connected
-	AdcChanConfigY.Rank         = 1;
-	AdcChanConfigY.SamplingTime = ADC_SAMPLETIME_3CYCLES;
-	AdcChanConfigY.Offset       = 0;
-
-	HAL_ADC_ConfigChannel(&AdcHandleY, &AdcChanConfigY);		//Initialise ADC Channel	//Initialise ADC Channel
+	//Enable priority (10) and interrupt callback. Do not set a priority lower than 5.
+	HAL_NVIC_SetPriority(ADC_IRQn, 10, 0);
+	HAL_NVIC_EnableIRQ(ADC_IRQn);
+}
+
+/*
+ * Wake the joystick task once a conversion of the axis falls outside low..high.
+ * The watchdog fires once, call again with the next window after reading the axis.
+ */
+void s4375116_reg_joystick_awd_window(int axis, int low, int high) {
+
+	ADC_TypeDef *adc = (axis == JOYSTICK_AXIS_Y) ? ADC2 : ADC1;
+
+	adc->CR1 &= ~ADC_CR1_AWDIE;
+	adc->LTR = (low < 0) ? 0 : low;
+	adc->HTR = (high > 0x0FFF) ? 0x0FFF : high;
+	adc->SR &= ~ADC_SR_AWD;		// drop a conversion outside the old window
+	adc->CR1 |= ADC_CR1_AWDIE;
+}
+
+/*
+ * Interrupt handler (ISR) for ADC 1, 2 and 3
+ * An axis left its window: disarm its watchdog and wake the joystick task
+ */
+void ADC_IRQHandler(void) {
+
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+	uint32_t axes = 0;
+
+	NVIC_ClearPendingIRQ(ADC_IRQn);
+
+	if ((ADC1->SR & ADC_SR_AWD) && (ADC1->CR1 & ADC_CR1_AWDIE)) {
+		ADC1->CR1 &= ~ADC_CR1_AWDIE;	// it would fire on every conversion until re-armed
+		ADC1->SR &= ~ADC_SR_AWD;
+		axes |= JOYSTICK_NOTIFY_X;
+	}
+	if ((ADC2->SR & ADC_SR_AWD) && (ADC2->CR1 & ADC_CR1_AWDIE)) {
+		ADC2->CR1 &= ~ADC_CR1_AWDIE;
+		ADC2->SR &= ~ADC_SR_AWD;
+		axes |= JOYSTICK_NOTIFY_Y;
+	}
+
+	if (axes != 0 && joystickTaskHandle != NULL) {	// Check if task exists
+		xTaskNotifyFromISR(joystickTaskHandle, axes, eSetBits, &xHigherPriorityTaskWoken);
+	}
+
+	// Perform context switching, if required.
+	portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+}
+
+/**
+ * Average of the most recent samples of one of the joystick's axes (JOYSTICK_AXIS_X or JOYSTICK_AXIS_Y),
+ * does not wait for a conversion
+ */
+int s4375116_joystick_read(int axis) {
+
+	unsigned int sum = 0;
+	int shift = (axis == JOYSTICK_AXIS_Y) ? 16 : 0;	// ADC2 result is in the upper half word
+
+	for (int i = 0; i < JOYSTICK_ADC_SAMPLES; i++) {
+		sum += (adcSamples[i] >> shift) & 0x0FFF;
+	}
+	return sum / JOYSTICK_ADC_SAMPLES;
+}
+
+/*
+ * Convert an adc value of an axis to calibrated units, -JOYSTICK_NORM_MAX at the minimum of the axis,
+ * 0 at its centre and JOYSTICK_NORM_MAX at its maximum. Each side is scaled on its own as the centre
+ * is rarely half way.
+ */
+int s4375116_joystick_normalise(int axis, int value) {
+
+	int deflection = value - joystickCal.centre[axis];
+	int span = (deflection >= 0) ? joystickCal.max[axis] - joystickCal.centre[axis] :
+			joystickCal.centre[axis] - joystickCal.min[axis];
+	int norm;
+
+	if (span <= 0) {
+		return 0;
+	}
+	norm = deflection * JOYSTICK_NORM_MAX / span;
+
+	if (norm > JOYSTICK_NORM_MAX) {
+		return JOYSTICK_NORM_MAX;
+	} else if (norm < -JOYSTICK_NORM_MAX) {
+		return -JOYSTICK_NORM_MAX;
+	}
+	return norm;
+}
+
+/*
+ * Ask the joystick task to run a calibration sweep: move the stick around its whole range for
+ * JOYSTICK_CAL_SWEEP_MS, then let go of it. The result is written to flash.
+ */
+void s4375116_joystick_cal_start(void) {
+
+	if (joystickTaskHandle != NULL) {	// Check if task exists
+		xTaskNotify(joystickTaskHandle, JOYSTICK_NOTIFY_CAL, eSetBits);
+	}
+}
+
+/*
+ * Calibration in use
+ */
+void s4375116_joystick_cal_get(JoystickCal *cal) {
+
+	taskENTER_CRITICAL();
+	*cal = joystickCal;
+	taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Load the calibration from flash and sample the centre, the stick is assumed to be at rest at boot.
+ * Without a stored calibration the full adc range is used around the sampled centre.
+ * 
+ */
+void joystick_cal_boot(void) {
+
+	JoystickCal cal;
+	int stored = (s4375116_reg_joystick_cal_load(&cal) == 0);
+	int centre;
+
+	if (!stored) {
+		cal = joystickCal;
+	}
+
+	for (int axis = JOYSTICK_AXIS_X; axis <= JOYSTICK_AXIS_Y; axis++) {
+		centre = s4375116_joystick_read(axis);
+		// someone holding the stick at boot would shift the whole scale, keep the stored centre then
+		if (centre > cal.min[axis] && centre < cal.max[axis] &&
+				(!stored || abs(centre - cal.centre[axis]) < JOYSTICK_CAL_CENTRE_DRIFT)) {
+			cal.centre[axis] = centre;
+		}
+	}
+
+	taskENTER_CRITICAL();
+	joystickCal = cal;
+	taskEXIT_CRITICAL();
+
+	JOYSTICK_LOG("Joystick %s calibration, centre x=%d y=%d\n\r", stored ? "stored" : "default",
+			cal.centre[JOYSTICK_AXIS_X], cal.centre[JOYSTICK_AXIS_Y]);
+}
+
+/*
+ * Set the function printing the calibration messages (NULL for debug_log), a task
+ * build whose uart output goes through a ring must not write the uart directly
+ */
+void s4375116_joystick_set_log(int (*log)(const char *fmt, ...)) {
+	joystickLog = log;
 }
 
 /**
- * Takes in the adc handle of one of the joystick's axes,
- * and returns the corresponding value
+ * @brief Record the extremes of both axes while the stick is moved around, then the centre once it is let go.
+ * The calibration is used and written to flash only if every side covers JOYSTICK_CAL_MIN_SPAN.
+ * 
  */
-int s4375116_joystick_readxy(ADC_HandleTypeDef AdcHandle) {
+void joystick_cal_sweep(void) {
 
-	unsigned int adc_value;	//holds the value of the specified adc 
+	JoystickCal cal;
+	int value;
 
-	HAL_ADC_Start(&AdcHandle); // Start ADC conversion
+	JOYSTICK_LOG("Joystick calibration: move the stick to every edge for %d s\n\r", JOYSTICK_CAL_SWEEP_MS / 1000);
 
-	// Wait for ADC conversion to finish
-	while (HAL_ADC_PollForConversion(&AdcHandle, 10) != HAL_OK);
+	for (int axis = JOYSTICK_AXIS_X; axis <= JOYSTICK_AXIS_Y; axis++) {
+		cal.min[axis] = 4095;
+		cal.max[axis] = 0;
+	}
 
-	// Check which ADC to read from
-	if (AdcHandle.Instance == AdcHandleX.Instance) {
+	for (int t = 0; t < JOYSTICK_CAL_SWEEP_MS; t += JOYSTICK_ACTIVE_PERIOD_MS) {
+		for (int axis = JOYSTICK_AXIS_X; axis <= JOYSTICK_AXIS_Y; axis++) {
+			value = s4375116_joystick_read(axis);
+			if (value < cal.min[axis]) {
+				cal.min[axis] = value;
+			}
+			if (value > cal.max[axis]) {
+				cal.max[axis] = value;
+			}
+		}
+		vTaskDelay(JOYSTICK_ACTIVE_PERIOD_MS);
+	}
 
-	    adc_value = ADC1->DR;		// Read ADC1 Data Register for converted value.
-		adc_value += S4375116_REG_JOYSTICK_X_ZERO_CAL_OFFSET; // Add offset to captured value
-		// debug_log("x=%d ", adc_value);
-	} else {
+	JOYSTICK_LOG("Joystick calibration: let go of the stick\n\r");
+	vTaskDelay(JOYSTICK_CAL_RELEASE_MS);
 
-		adc_value = ADC2->DR;		// Read ADC2 Data Register for converted value.
-		adc_value += S4375116_REG_JOYSTICK_Y_ZERO_CAL_OFFSET; // Add offset to captured value
-		// debug_log("y=%d\n\r", adc_value);
+	for (int axis = JOYSTICK_AXIS_X; axis <= JOYSTICK_AXIS_Y; axis++) {
+		cal.centre[axis] = s4375116_joystick_read(axis);
+		if (cal.max[axis] - cal.centre[axis] < JOYSTICK_CAL_MIN_SPAN || cal.centre[axis] - cal.min[axis] < JOYSTICK_CAL_MIN_SPAN) {
+			JOYSTICK_LOG("Joystick calibration failed, %c axis only covered %d to %d around %d\n\r", axis ? 'y' : 'x',
+					cal.min[axis], cal.max[axis], cal.centre[axis]);
+			return;
+		}
 	}
-	return adc_value;
+
+	taskENTER_CRITICAL();
+	joystickCal = cal;
+	taskEXIT_CRITICAL();
+
+	JOYSTICK_LOG("Joystick calibration x=%d/%d/%d y=%d/%d/%d (min/centre/max) %s\n\r",
+			cal.min[JOYSTICK_AXIS_X], cal.centre[JOYSTICK_AXIS_X], cal.max[JOYSTICK_AXIS_X],
+			cal.min[JOYSTICK_AXIS_Y], cal.centre[JOYSTICK_AXIS_Y], cal.max[JOYSTICK_AXIS_Y],
+			(s4375116_reg_joystick_cal_save(&cal) == 0) ? "saved" : "could not be saved");
 }
 
 /**
- * @brief Control task to creat push button semaphore and initialise hardware
+ * @brief Arm the analog watchdog of an axis to fire once the axis moves JOYSTICK_AWD_DEADBAND away from value
+ * 
+ */
+void joystick_awd_around(int axis, int value) {
+	s4375116_reg_joystick_awd_window(axis, value - JOYSTICK_AWD_DEADBAND, value + JOYSTICK_AWD_DEADBAND);
+}
+
+/**
+ * @brief Control task to creat push button semaphore and initialise hardware.
+ * While the stick moves the axes are low pass filtered and sent every JOYSTICK_ACTIVE_PERIOD_MS,
+ * once the filter has settled the task sleeps until an analog watchdog sees the stick move again.
+ * Readings are sent in calibrated units (s4375116_joystick_normalise).
  * 
  */
 void s4375116TaskJoystick(void) {
@@ -266,20 +466,50 @@ void s4375116TaskJoystick(void) {
 	portENABLE_INTERRUPTS();	//Enable interrupts
 
 	adcMessage_t sendAdcMessage; //message struct sent to CAG_joystick
-
+	uint32_t notifyBits;
+	int rawX;
+	int rawY;
+	int filteredX; // IIR filter state, adc value << JOYSTICK_FILTER_SHIFT
+	int filteredY;
+
+	// let the averaging buffer fill before the first reading
+	vTaskDelay(JOYSTICK_ADC_SAMPLES * 1000 / JOYSTICK_SAMPLE_HZ);
+	joystick_cal_boot();
+	filteredX = S4375116_REG_JOYSTICK_X_READ() << JOYSTICK_FILTER_SHIFT;
+	filteredY = S4375116_REG_JOYSTICK_Y_READ() << JOYSTICK_FILTER_SHIFT;
 
 	for(;;) {
 
 		// Get x and y adc value from the joystick
-		sendAdcMessage.adcX = S4375116_REG_JOYSTICK_X_READ();
-		sendAdcMessage.adcY = S4375116_REG_JOYSTICK_Y_READ();
+		rawX = S4375116_REG_JOYSTICK_X_READ();
+		rawY = S4375116_REG_JOYSTICK_Y_READ();
+
+		// first order IIR, each reading moves the output 1/2^JOYSTICK_FILTER_ALPHA_SHIFT of the way
+		filteredX += ((rawX << JOYSTICK_FILTER_SHIFT) - filteredX) >> JOYSTICK_FILTER_ALPHA_SHIFT;
+		filteredY += ((rawY << JOYSTICK_FILTER_SHIFT) - filteredY) >> JOYSTICK_FILTER_ALPHA_SHIFT;
+
+		sendAdcMessage.adcX = s4375116_joystick_normalise(JOYSTICK_AXIS_X, filteredX >> JOYSTICK_FILTER_SHIFT);
+		sendAdcMessage.adcY = s4375116_joystick_normalise(JOYSTICK_AXIS_Y, filteredY >> JOYSTICK_FILTER_SHIFT);
 		// debug_log("adc x=%d,adc y=%d\n\r",sendAdcMessage.adcX, sendAdcMessage.adcY);
 		//send adc values to cag joystick
 		if (joystickMessageQueue != NULL) {	// Check if queue exists 
-			xQueueSendToFront(joystickMessageQueue, ( void * ) &sendAdcMessage, ( portTickType ) 10 );
+			xQueueSendToBack(joystickMessageQueue, ( void * ) &sendAdcMessage, ( portTickType ) 10 );
+		}
+
+		if (abs(rawX - (filteredX >> JOYSTICK_FILTER_SHIFT)) > JOYSTICK_SETTLED ||
+				abs(rawY - (filteredY >> JOYSTICK_FILTER_SHIFT)) > JOYSTICK_SETTLED) {
+			// still moving, keep filtering (a calibration request ends the wait early)
+			xTaskNotifyWait(0, JOYSTICK_NOTIFY_X | JOYSTICK_NOTIFY_Y | JOYSTICK_NOTIFY_CAL, &notifyBits, JOYSTICK_ACTIVE_PERIOD_MS);
+		} else {
+			// sleep until the stick moves again
+			joystick_awd_around(JOYSTICK_AXIS_X, rawX);
+			joystick_awd_around(JOYSTICK_AXIS_Y, rawY);
+			xTaskNotifyWait(0, JOYSTICK_NOTIFY_X | JOYSTICK_NOTIFY_Y | JOYSTICK_NOTIFY_CAL, &notifyBits, portMAX_DELAY);
 		}
 
-		vTaskDelay(100);
+		if (notifyBits & JOYSTICK_NOTIFY_CAL) {
+			joystick_cal_sweep();
+		}
 	}
 }
 
@@ -289,6 +519,9 @@ void s4375116TaskJoystick(void) {
  */
 void s4375116_tsk_joystick_init(void) {
 
-	xTaskCreate( (void *) &s4375116TaskJoystick, (const signed char *) "JOYSTICK", JOYSTICKTASK_STACK_SIZE, NULL, JOYSTICKTASK_PRIORITY, NULL );
+	// created before the scheduler starts so the cag joystick task can wait on it
+	joystickPbEventQueue = xQueueCreate(JOYSTICK_PB_QUEUE_LENGTH, sizeof(DebounceEvent));
+
+	xTaskCreate( (void *) &s4375116TaskJoystick, (const signed char *) "JOYSTICK", JOYSTICKTASK_STACK_SIZE, NULL, JOYSTICKTASK_PRIORITY, &joystickTaskHandle );
 
-}
\ No newline at end of file
+}
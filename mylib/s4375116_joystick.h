@@ -13,7 +13,12 @@
  * s4375116_reg_joystick_press_get() - Returns the value of the Joystick pushbutton press
  * s4375116_reg_joystick_press_reset() - Reset the Joystick event counter value to 0
  * s4375116_reg_joystick_init() - Initialise pins as ADC inputs from the joystick
- * s4375116_joystick_readxy() - Read ADC value from one of the joystick axes (x or y)
+ * s4375116_joystick_read() - Latest averaged ADC value of one of the joystick axes (x or y)
+ * s4375116_reg_joystick_awd_window() - Wake the joystick task when an axis leaves a window
+ * s4375116_joystick_normalise() - Convert an adc value of an axis to calibrated units
+ * s4375116_joystick_cal_start() - Ask the joystick task to run a calibration sweep
+ * s4375116_joystick_cal_get() - Calibration in use
+ * s4375116_joystick_set_log() - Set the function printing the calibration messages
  * s4375116_tsk_joystick_init() - Create Joystick Task
  *************************************************************** 
  */
@@ -21,22 +26,44 @@
 #ifndef S4375116_JOYSTICK_H
 #define s4375116_JOYSTICK_H
 
-#define S4375116_REG_JOYSTICK_X_ZERO_CAL_OFFSET 0
-#define S4375116_REG_JOYSTICK_Y_ZERO_CAL_OFFSET 0
-#define S4375116_REG_JOYSTICK_X_READ()  s4375116_joystick_readxy(AdcHandleX)
-#define S4375116_REG_JOYSTICK_Y_READ()  s4375116_joystick_readxy(AdcHandleY)
+#include "s4375116_joystick_cal.h"
+
+#define S4375116_REG_JOYSTICK_X_READ()  s4375116_joystick_read(JOYSTICK_AXIS_X)
+#define S4375116_REG_JOYSTICK_Y_READ()  s4375116_joystick_read(JOYSTICK_AXIS_Y)
+
+#define JOYSTICK_AXIS_X			0
+#define JOYSTICK_AXIS_Y			1
+#define JOYSTICK_SAMPLE_HZ		1000		// conversions per second on each axis
+#define JOYSTICK_ADC_SAMPLES	16			// samples averaged by a read (the last 16 ms)
+#define JOYSTICK_ADC_DMA		DMA2_Stream0	// channel 0 is ADC1
+
+// Joystick task notification bits, set by the analog watchdog interrupt
+#define JOYSTICK_NOTIFY_X		(1UL << 0)	// x axis left its window
+#define JOYSTICK_NOTIFY_Y		(1UL << 1)	// y axis left its window
+#define JOYSTICK_NOTIFY_CAL		(1UL << 2)	// run a calibration sweep (s4375116_joystick_cal_start)
+
+#define JOYSTICK_NORM_MAX				1000	// calibrated reading at either end of an axis, 0 at the centre
+#define JOYSTICK_CAL_SWEEP_MS			5000	// time given to move the stick around its whole range
+#define JOYSTICK_CAL_RELEASE_MS			1000	// time given to let go of the stick before the centre is sampled
+#define JOYSTICK_CAL_MIN_SPAN			500		// adc counts each side of the centre a sweep must reach to be kept
+#define JOYSTICK_CAL_CENTRE_DRIFT		400		// boot centre further than this from the stored one: stick held, keep stored
+
+#define JOYSTICK_AWD_DEADBAND			48	// movement (adc counts) that wakes the joystick task
+#define JOYSTICK_ACTIVE_PERIOD_MS		20	// time between readings while the stick moves
+#define JOYSTICK_FILTER_SHIFT			4	// fraction bits of the filter state
+#define JOYSTICK_FILTER_ALPHA_SHIFT		2	// filter gain 1/4 per reading
+#define JOYSTICK_SETTLED				8	// filter output this close to the reading: go back to sleep
 
 // Task Priorities (Idle Priority is the lowest priority)
 #define JOYSTICKTASK_PRIORITY					( tskIDLE_PRIORITY + 2 )
 // Task Stack Allocations (must be a multiple of the minimal stack size)
 #define JOYSTICKTASK_STACK_SIZE		( configMINIMAL_STACK_SIZE * 2 )
 
-ADC_HandleTypeDef AdcHandleX;
-ADC_ChannelConfTypeDef AdcChanConfigX;
-ADC_HandleTypeDef AdcHandleY;
-ADC_ChannelConfTypeDef AdcChanConfigY;
+#define JOYSTICK_PB_QUEUE_LENGTH	4
+
 SemaphoreHandle_t LTpbSemaphore;	// Semaphore for pushbutton interrupt
 SemaphoreHandle_t RTpbSemaphore;	// Semaphore for pushbutton interrupt
+QueueHandle_t joystickPbEventQueue;	// Debounced pushbutton events (DebounceEvent)
 
 
 void s4375116_reg_joystick_pb_init(void);
@@ -44,7 +71,12 @@ void s4375116_reg_joystick_pb_isr(void);
 int s4375116_reg_joystick_press_get(void);
 void s4375116_reg_joystick_press_reset(void);
 void s4375116_reg_joystick_init(void);
-int s4375116_joystick_readxy(ADC_HandleTypeDef AdcHandle);
+int s4375116_joystick_read(int axis);
+void s4375116_reg_joystick_awd_window(int axis, int low, int high);
+int s4375116_joystick_normalise(int axis, int value);
+void s4375116_joystick_cal_start(void);
+void s4375116_joystick_cal_get(JoystickCal *cal);
+void s4375116_joystick_set_log(int (*log)(const char *fmt, ...));
 void s4375116_tsk_joystick_init(void);
         
 #endif
\ No newline at end of file
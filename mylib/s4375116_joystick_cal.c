@@ -0,0 +1,107 @@
+ /**
+ **************************************************************
+ * @file mylib/s4375116_joystick_cal.c
+ * @author Sami Kaab - s4375116
+ * @date 19102026
+ * @brief Joystick calibration record kept in flash
+ * The last flash sector holds one record: magic, version, the calibration and
+ * a CRC-32 of everything before it. A blank or damaged sector reads as no record.
+ * The sector is in the second flash bank, so the program keeps running from the
+ * first bank while it is erased.
+ * REFERENCE: STM32F429 reference manual (RM0090) embedded flash chapter
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4375116_reg_joystick_cal_load() - read the calibration record from flash
+ * s4375116_reg_joystick_cal_save() - erase the sector and write a calibration record
+ ***************************************************************
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "board.h"
+#include "processor_hal.h"
+
+#include "s4375116_joystick_cal.h"
+
+// record as stored in flash, a whole number of words
+struct calRecord {
+	uint32_t magic;
+	uint32_t version;
+	JoystickCal cal;
+	uint32_t crc;	// CRC-32 of the fields above
+};
+
+/**
+ * @brief CRC-32 (IEEE 802.3, reflected) of a buffer
+ * 
+ */
+uint32_t cal_crc32(const uint8_t *data, int len) {
+
+	uint32_t crc = 0xFFFFFFFF;
+
+	for (int i = 0; i < len; i++) {
+		crc ^= data[i];
+		for (int bit = 0; bit < 8; bit++) {
+			crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 0x01));
+		}
+	}
+	return ~crc;
+}
+
+/*
+ * Read the calibration record from flash.
+ * Returns 0 and fills cal if a valid record is stored, -1 otherwise
+ */
+int s4375116_reg_joystick_cal_load(JoystickCal *cal) {
+
+	struct calRecord record;
+
+	memcpy(&record, (const void *) JOYSTICK_CAL_FLASH_ADDR, sizeof(record));
+
+	if (record.magic != JOYSTICK_CAL_MAGIC || record.version != JOYSTICK_CAL_VERSION ||
+			record.crc != cal_crc32((const uint8_t *) &record, offsetof(struct calRecord, crc))) {
+		return -1;
+	}
+	*cal = record.cal;
+	return 0;
+}
+
+/*
+ * Erase the calibration sector and write a record, blocks for the erase (up to 2 s).
+ * Returns 0 on success, -1 if the flash could not be erased or written
+ */
+int s4375116_reg_joystick_cal_save(const JoystickCal *cal) {
+
+	struct calRecord record;
+	FLASH_EraseInitTypeDef erase;
+	uint32_t sectorError;
+	const uint32_t *words = (const uint32_t *) &record;
+	int status = 0;
+
+	memset(&record, 0, sizeof(record));
+	record.magic = JOYSTICK_CAL_MAGIC;
+	record.version = JOYSTICK_CAL_VERSION;
+	record.cal = *cal;
+	record.crc = cal_crc32((const uint8_t *) &record, offsetof(struct calRecord, crc));
+
+	erase.TypeErase = FLASH_TYPEERASE_SECTORS;
+	erase.Sector = JOYSTICK_CAL_FLASH_SECTOR;
+	erase.NbSectors = 1;
+	erase.VoltageRange = FLASH_VOLTAGE_RANGE_3;	// 2.7V to 3.6V, 32 bit writes
+
+	HAL_FLASH_Unlock();
+
+	if (HAL_FLASHEx_Erase(&erase, &sectorError) != HAL_OK) {
+		status = -1;
+	}
+	for (unsigned int i = 0; status == 0 && i < sizeof(record) / 4; i++) {
+		if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, JOYSTICK_CAL_FLASH_ADDR + 4 * i, words[i]) != HAL_OK) {
+			status = -1;
+		}
+	}
+
+	HAL_FLASH_Lock();
+	return status;
+}
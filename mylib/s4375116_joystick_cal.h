@@ -0,0 +1,39 @@
+ /**
+ **************************************************************
+ * @file mylib/s4375116_joystick_cal.h
+ * @author Sami Kaab - s4375116
+ * @date 19102026
+ * @brief Joystick calibration record kept in flash
+ * The last flash sector holds one record: magic, version, the calibration and
+ * a CRC-32 of everything before it. A blank or damaged sector reads as no record.
+ * REFERENCE: STM32F429 reference manual (RM0090) embedded flash chapter
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4375116_reg_joystick_cal_load() - read the calibration record from flash
+ * s4375116_reg_joystick_cal_save() - erase the sector and write a calibration record
+ ***************************************************************
+ */
+
+#ifndef S4375116_JOYSTICK_CAL_H
+#define S4375116_JOYSTICK_CAL_H
+
+#include <stdint.h>
+
+#define JOYSTICK_CAL_FLASH_SECTOR	FLASH_SECTOR_23		// last 128KB sector of the 2MB flash
+#define JOYSTICK_CAL_FLASH_ADDR		0x081E0000
+#define JOYSTICK_CAL_MAGIC			0x4C41434A			// "JCAL"
+#define JOYSTICK_CAL_VERSION		1
+
+// calibration of both joystick axes (raw adc counts), indexed by JOYSTICK_AXIS_X / JOYSTICK_AXIS_Y
+struct joystickCal {
+	uint16_t centre[2];
+	uint16_t min[2];
+	uint16_t max[2];
+};
+typedef struct joystickCal JoystickCal;
+
+int s4375116_reg_joystick_cal_load(JoystickCal *cal);
+int s4375116_reg_joystick_cal_save(const JoystickCal *cal);
+
+#endif
@@ -0,0 +1,121 @@
+ /**
+ **************************************************************
+ * @file mylib/s4375116_latency.c
+ * @author Sami Kaab - s4375116
+ * @date 19102026
+ * @brief Input to screen latency histograms
+ * A key is stamped when the console task hands it to the grid or cli handler,
+ * the stamp travels with the simulator command and the display frame, and each
+ * stage records the time since the previous one.
+ * Stamps are DWT cycle counts so they cost one register read and resolve well
+ * below a tick. The counter wraps after 2^32 cycles (about 23 s at 180 MHz),
+ * the difference of two stamps is correct as long as the stage is shorter.
+ * REFERENCE: ARMv7-M architecture reference manual (DWT_CYCCNT)
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4375116_reg_latency_init() - start the cycle counter used for stamps
+ * s4375116_latency_now() - take a stamp
+ * s4375116_latency_record() - add the time between two stamps to a stage histogram
+ * s4375116_latency_get() - copy the histogram of a stage
+ * s4375116_latency_reset() - empty every histogram
+ * s4375116_latency_stage_name() - short name of a stage
+ ***************************************************************
+ */
+
+#include <string.h>
+
+#include "board.h"
+#include "processor_hal.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "s4375116_latency.h"
+
+static LatencyHist hists[LATENCY_STAGES];
+
+static const char *const stageNames[LATENCY_STAGES] = {"key>apply", "apply>queue", "queue>screen", "key>screen"};
+
+/*
+ * Start the DWT cycle counter used for stamps and empty the histograms
+ */
+void s4375116_reg_latency_init(void) {
+
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;	// enable the DWT unit
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	s4375116_latency_reset();
+}
+
+/*
+ * Take a stamp, never LATENCY_NONE
+ */
+uint32_t s4375116_latency_now(void) {
+
+	uint32_t stamp = DWT->CYCCNT;
+
+	return (stamp == LATENCY_NONE) ? stamp + 1 : stamp;
+}
+
+/*
+ * Add the time from start to end to the histogram of a stage.
+ * Nothing is recorded if start was never stamped.
+ */
+void s4375116_latency_record(int stage, uint32_t start, uint32_t end) {
+
+	uint32_t us;
+	int bucket = 0;
+	LatencyHist *hist;
+
+	if (start == LATENCY_NONE || stage < 0 || stage >= LATENCY_STAGES) {
+		return;
+	}
+
+	us = (end - start) / (SystemCoreClock / 1000000);
+	while (bucket < LATENCY_BUCKETS - 1 && (us >> (bucket + 1)) != 0) {
+		bucket++;
+	}
+
+	// stages are recorded from different tasks
+	taskENTER_CRITICAL();
+	hist = &hists[stage];
+	if (hist->count == 0 || us < hist->min) {
+		hist->min = us;
+	}
+	if (us > hist->max) {
+		hist->max = us;
+	}
+	hist->count++;
+	hist->total += us;
+	hist->buckets[bucket]++;
+	taskEXIT_CRITICAL();
+}
+
+/*
+ * Copy the histogram of a stage
+ */
+void s4375116_latency_get(int stage, LatencyHist *hist) {
+
+	taskENTER_CRITICAL();
+	*hist = hists[stage];
+	taskEXIT_CRITICAL();
+}
+
+/*
+ * Empty every histogram
+ */
+void s4375116_latency_reset(void) {
+
+	taskENTER_CRITICAL();
+	memset(hists, 0, sizeof(hists));
+	taskEXIT_CRITICAL();
+}
+
+/*
+ * Short name of a stage
+ */
+const char *s4375116_latency_stage_name(int stage) {
+	return stageNames[stage];
+}
@@ -0,0 +1,61 @@
+ /**
+ **************************************************************
+ * @file mylib/s4375116_latency.h
+ * @author Sami Kaab - s4375116
+ * @date 19102026
+ * @brief Input to screen latency histograms
+ * A key is stamped when the console task hands it to the grid or cli handler,
+ * the stamp travels with the simulator command and the display frame, and each
+ * stage records the time since the previous one:
+ *  key>apply     console received the key -> simulator applied the command
+ *  apply>queue   simulator applied the command -> frame queued for the display
+ *  queue>screen  frame queued -> oled update finished
+ *  key>screen    the whole path
+ * Stamps are DWT cycle counts, latencies are kept in microseconds.
+ * REFERENCE: ARMv7-M architecture reference manual (DWT_CYCCNT)
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4375116_reg_latency_init() - start the cycle counter used for stamps
+ * s4375116_latency_now() - take a stamp
+ * s4375116_latency_record() - add the time between two stamps to a stage histogram
+ * s4375116_latency_get() - copy the histogram of a stage
+ * s4375116_latency_reset() - empty every histogram
+ * s4375116_latency_stage_name() - short name of a stage
+ ***************************************************************
+ */
+
+#ifndef S4375116_LATENCY_H
+#define S4375116_LATENCY_H
+
+#include <stdint.h>
+
+#define LATENCY_INPUT_APPLIED	0	// key>apply
+#define LATENCY_APPLIED_QUEUED	1	// apply>queue
+#define LATENCY_QUEUED_SCREEN	2	// queue>screen
+#define LATENCY_INPUT_SCREEN	3	// key>screen
+#define LATENCY_STAGES			4
+
+// bucket b counts latencies of 2^b to 2^(b+1)-1 us (bucket 0 also holds 0 us), the last bucket everything longer
+#define LATENCY_BUCKETS			22
+
+#define LATENCY_NONE			0	// stamp value meaning "not measured"
+
+// latency histogram of one stage
+struct latencyHist {
+	uint32_t count;
+	uint32_t min;		// us
+	uint32_t max;		// us
+	uint64_t total;		// us, for the average
+	uint32_t buckets[LATENCY_BUCKETS];
+};
+typedef struct latencyHist LatencyHist;
+
+void s4375116_reg_latency_init(void);
+uint32_t s4375116_latency_now(void);
+void s4375116_latency_record(int stage, uint32_t start, uint32_t end);
+void s4375116_latency_get(int stage, LatencyHist *hist);
+void s4375116_latency_reset(void);
+const char *s4375116_latency_stage_name(int stage);
+
+#endif
@@ -23,6 +23,10 @@
 #include "oled_string.h"
 #include "fonts.h"
 #include "s4375116_oled.h"
+#include "s4375116_oled_fb.h"
+
+/* text currently shown on the panel */
+static OledFbText shownText;
 
 
 
@@ -92,17 +96,20 @@ void s4375116_reg_oled_init(void) {
 }
 
 /**
- * @brief Writes message as specified in the oledTextMsg struct to the oled
+ * @brief Writes message as specified in the oledTextMsg struct to the oled.
+ * Only the characters that differ from the text on screen are redrawn and sent.
  * 
  * @param RcvdMsg 
  */
-void write_to_oled(OledTextMsg RcvdMsg) {
-	//Clear Screen
-	ssd1306_Fill(Black);
+void write_to_oled(const OledTextMsg *RcvdMsg) {
+	// text moved, start again from a blank screen
+	if (RcvdMsg->startX != shownText.x || RcvdMsg->startY != shownText.y) {
+		s4375116_lib_oled_fb_clear();
+		s4375116_lib_oled_fb_text_init(&shownText, RcvdMsg->startX, RcvdMsg->startY);
+	}
 	//Show text and udpate screen
-	ssd1306_SetCursor(RcvdMsg.startX,RcvdMsg.startY);
-	ssd1306_WriteString(RcvdMsg.displayText, Font_7x10, SSD1306_WHITE);
-	ssd1306_UpdateScreen();
+	s4375116_lib_oled_fb_text_update(&shownText, RcvdMsg->displayText);
+	s4375116_lib_oled_fb_flush();
 }
 
 /**
@@ -118,6 +125,8 @@ void s4375116TaskOled(void) {
 
 	portENABLE_INTERRUPTS();	//Enable interrupts
 
+	// panel is blank after init
+	s4375116_lib_oled_fb_text_init(&shownText, 0, 0);
 
 	OledTextMsg RcvdMsg;
 	
@@ -132,7 +141,7 @@ void s4375116TaskOled(void) {
 			// Check for item received - block atmost for 10 ticks
 			if (xQueueReceive( OledMessageQueue, &RcvdMsg, 10 )) {
 
-				write_to_oled(RcvdMsg);
+				write_to_oled(&RcvdMsg);
         	}
 		}
 
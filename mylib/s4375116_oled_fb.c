@@ -0,0 +1,215 @@
+ /**
+ **************************************************************
+ * @file mylib/s4375116_oled_fb.c
+ * @author Sami Kaab - s4375116 
+ * @date 19102026
+ * @brief OLED frame buffer that only sends the bytes that changed
+ * Keeps a copy of the panel memory, marks changed columns dirty and sends just
+ * those columns on flush. Text is drawn from a cache of pre-rasterised glyphs.
+ * Only uses the ssd1306 command/data functions so it also builds on the host (see host/)
+ * REFERENCE: SSD1306 datasheet (page addressing mode)
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4375116_lib_oled_fb_clear() - clear the frame buffer
+ * s4375116_lib_oled_fb_put() - write pixels into one column byte of a page
+ * s4375116_lib_oled_fb_glyph() - draw a cached glyph at any pixel position
+ * s4375116_lib_oled_fb_text_init() - set the position of a text field and blank it
+ * s4375116_lib_oled_fb_text_update() - redraw only the characters of a text field that changed
+ * s4375116_lib_oled_fb_flush() - send the dirty columns to the panel
+ ***************************************************************
+ */
+
+#include <string.h>
+
+#include "oled_pixel.h"
+#include "oled_string.h"
+#include "fonts.h"
+
+#include "s4375116_oled_fb.h"
+
+#define GLYPH_FIRST		' '
+#define GLYPH_LAST		'~'
+#define GLYPH_COUNT		(GLYPH_LAST - GLYPH_FIRST + 1)
+
+/* a clean gap shorter than this is sent anyway, starting a new column window costs more */
+#define FLUSH_MERGE_GAP	8
+
+static uint8_t fb[OLED_FB_PAGES][OLED_FB_WIDTH];		// copy of the panel memory
+static uint32_t dirty[OLED_FB_PAGES][OLED_FB_WIDTH / 32];	// one bit per changed column
+static uint8_t dirtyPages;								// one bit per page with dirty columns
+
+/* glyph columns, bit n is glyph row n. Rasterised from the font the first time a character is drawn */
+static uint16_t glyphs[GLYPH_COUNT][OLED_FB_GLYPH_WIDTH];
+static uint8_t glyphCached[GLYPH_COUNT];
+
+/*
+ * Clear the frame buffer, only columns that had pixels set become dirty
+ */
+void s4375116_lib_oled_fb_clear(void) {
+
+	for (int page = 0; page < OLED_FB_PAGES; page++) {
+		for (int x = 0; x < OLED_FB_WIDTH; x++) {
+			s4375116_lib_oled_fb_put(x, page, 0x00, 0xFF);
+		}
+	}
+}
+
+/*
+ * Write the pixels selected by mask into the column byte at x of a page (bit 0 is the top row of the page)
+ */
+void s4375116_lib_oled_fb_put(int x, int page, uint8_t bits, uint8_t mask) {
+
+	uint8_t value;
+
+	if (x < 0 || x >= OLED_FB_WIDTH || page < 0 || page >= OLED_FB_PAGES) {
+		return;
+	}
+
+	value = (fb[page][x] & ~mask) | (bits & mask);
+	if (value != fb[page][x]) {
+		fb[page][x] = value;
+		dirty[page][x / 32] |= 1UL << (x % 32);
+		dirtyPages |= 1 << page;
+	}
+}
+
+/**
+ * @brief Get the cached columns of a glyph, rasterising it from the font on first use
+ * 
+ * @param ch printable character
+ * @return const uint16_t* glyph columns, bit n is glyph row n
+ */
+static const uint16_t *glyph_columns(char ch) {
+
+	int index = ch - GLYPH_FIRST;
+	uint16_t row;
+
+	if (!glyphCached[index]) {
+		memset(glyphs[index], 0, sizeof(glyphs[index]));
+		for (int y = 0; y < OLED_FB_GLYPH_HEIGHT; y++) {
+			row = Font_7x10.data[index * Font_7x10.FontHeight + y];
+			for (int x = 0; x < OLED_FB_GLYPH_WIDTH; x++) {
+				if ((row << x) & 0x8000) {
+					glyphs[index][x] |= 1 << y;
+				}
+			}
+		}
+		glyphCached[index] = 1;
+	}
+	return glyphs[index];
+}
+
+/*
+ * Draw a glyph with its top left corner at pixel (x, y), background pixels are cleared
+ */
+void s4375116_lib_oled_fb_glyph(int x, int y, char ch) {
+
+	const uint16_t *columns;
+	uint32_t bits;
+	uint32_t mask = ((1UL << OLED_FB_GLYPH_HEIGHT) - 1) << (y % 8);
+	int page = y / 8;
+
+	if (ch < GLYPH_FIRST || ch > GLYPH_LAST) {
+		ch = ' ';
+	}
+	columns = glyph_columns(ch);
+
+	for (int i = 0; i < OLED_FB_GLYPH_WIDTH; i++) {
+		bits = (uint32_t) columns[i] << (y % 8);
+		// a 10 pixel glyph spans two or three pages
+		for (int p = 0; (mask >> (8 * p)) != 0; p++) {
+			s4375116_lib_oled_fb_put(x + i, page + p, bits >> (8 * p), mask >> (8 * p));
+		}
+	}
+}
+
+/*
+ * Set the position of a text field and blank it
+ */
+void s4375116_lib_oled_fb_text_init(OledFbText *text, int x, int y) {
+
+	text->x = x;
+	text->y = y;
+	memset(text->shown, ' ', OLED_FB_TEXT_MAX);
+	text->shown[OLED_FB_TEXT_MAX] = '\0';
+	for (int i = 0; i < OLED_FB_TEXT_MAX && text->x + (i + 1) * OLED_FB_GLYPH_WIDTH <= OLED_FB_WIDTH; i++) {
+		s4375116_lib_oled_fb_glyph(text->x + i * OLED_FB_GLYPH_WIDTH, text->y, ' ');
+	}
+}
+
+/*
+ * Show str in a text field. Only characters that differ from what is shown are redrawn,
+ * characters past the end of str are blanked.
+ */
+void s4375116_lib_oled_fb_text_update(OledFbText *text, const char *str) {
+
+	char ch;
+
+	for (int i = 0; i < OLED_FB_TEXT_MAX && text->x + (i + 1) * OLED_FB_GLYPH_WIDTH <= OLED_FB_WIDTH; i++) {
+		ch = (*str != '\0') ? *str++ : ' ';
+		if (ch != text->shown[i]) {
+			s4375116_lib_oled_fb_glyph(text->x + i * OLED_FB_GLYPH_WIDTH, text->y, ch);
+			text->shown[i] = ch;
+		}
+	}
+}
+
+/**
+ * @brief Check whether column x of a page is dirty
+ * 
+ * @param page the page
+ * @param x the column
+ * @return int non zero if the column changed since the last flush
+ */
+static int column_dirty(int page, int x) {
+
+	return (dirty[page][x / 32] >> (x % 32)) & 0x01;
+}
+
+/*
+ * Send the dirty columns to the panel and return the number of data bytes sent.
+ * Each run of dirty columns in a page is sent as one data transfer after setting
+ * the page and start column, close runs are merged.
+ */
+int s4375116_lib_oled_fb_flush(void) {
+
+	int sent = 0;
+	int start, end, x;
+
+	for (int page = 0; page < OLED_FB_PAGES; page++) {
+
+		if (!(dirtyPages & (1 << page))) {
+			continue;
+		}
+
+		x = 0;
+		while (x < OLED_FB_WIDTH) {
+			if (!column_dirty(page, x)) {
+				x++;
+				continue;
+			}
+
+			// extend the run over dirty columns and short clean gaps
+			start = x;
+			end = x;
+			while (x < OLED_FB_WIDTH && x - end <= FLUSH_MERGE_GAP) {
+				if (column_dirty(page, x)) {
+					end = x;
+				}
+				x++;
+			}
+
+			ssd1306_WriteCommand(0xB0 + page);				// page start
+			ssd1306_WriteCommand(0x00 | (start & 0x0F));	// lower column start nibble
+			ssd1306_WriteCommand(0x10 | (start >> 4));		// upper column start nibble
+			ssd1306_WriteData(&fb[page][start], end - start + 1);
+			sent += end - start + 1;
+		}
+
+		memset(dirty[page], 0, sizeof(dirty[page]));
+	}
+	dirtyPages = 0;
+
+	return sent;
+}
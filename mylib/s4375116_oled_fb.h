@@ -0,0 +1,49 @@
+ /**
+ **************************************************************
+ * @file mylib/s4375116_oled_fb.h
+ * @author Sami Kaab - s4375116 
+ * @date 19102026
+ * @brief OLED frame buffer that only sends the bytes that changed
+ * Keeps a copy of the panel memory, marks changed columns dirty and sends just
+ * those columns on flush. Text is drawn from a cache of pre-rasterised glyphs.
+ * Only uses the ssd1306 command/data functions so it also builds on the host (see host/)
+ * REFERENCE: SSD1306 datasheet (page addressing mode)
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4375116_lib_oled_fb_clear() - clear the frame buffer
+ * s4375116_lib_oled_fb_put() - write pixels into one column byte of a page
+ * s4375116_lib_oled_fb_glyph() - draw a cached glyph at any pixel position
+ * s4375116_lib_oled_fb_text_init() - set the position of a text field and blank it
+ * s4375116_lib_oled_fb_text_update() - redraw only the characters of a text field that changed
+ * s4375116_lib_oled_fb_flush() - send the dirty columns to the panel
+ ***************************************************************
+ */
+
+#ifndef S4375116_OLED_FB_H
+#define S4375116_OLED_FB_H
+
+#include <stdint.h>
+
+#define OLED_FB_WIDTH		128	// pixels
+#define OLED_FB_PAGES		8	// 8 pixel rows per page
+#define OLED_FB_GLYPH_WIDTH	7	// Font_7x10
+#define OLED_FB_GLYPH_HEIGHT	10
+#define OLED_FB_TEXT_MAX	(OLED_FB_WIDTH / OLED_FB_GLYPH_WIDTH)	// characters on one line
+
+// a line of text on the panel, remembers what is currently shown
+struct oledFbText {
+	uint8_t x;	// top left pixel of the first character
+	uint8_t y;
+	char shown[OLED_FB_TEXT_MAX + 1];
+};
+typedef struct oledFbText OledFbText;
+
+void s4375116_lib_oled_fb_clear(void);
+void s4375116_lib_oled_fb_put(int x, int page, uint8_t bits, uint8_t mask);
+void s4375116_lib_oled_fb_glyph(int x, int y, char ch);
+void s4375116_lib_oled_fb_text_init(OledFbText *text, int x, int y);
+void s4375116_lib_oled_fb_text_update(OledFbText *text, const char *str);
+int s4375116_lib_oled_fb_flush(void);
+
+#endif
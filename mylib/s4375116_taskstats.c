@@ -0,0 +1,123 @@
+ /**
+ **************************************************************
+ * @file mylib/s4375116_taskstats.c
+ * @author Sami Kaab - s4375116
+ * @date 19102026
+ * @brief Per task cpu use and stack use
+ * TIM5 (32 bit) free runs at TASKSTATS_COUNTER_FREQ as the FreeRTOS run time stats
+ * counter (portGET_RUN_TIME_COUNTER_VALUE in FreeRTOSConfig.h). A sample gives
+ * the counts each task ran since the previous sample, so the counter may wrap.
+ * configCHECK_FOR_STACK_OVERFLOW calls the hook here, which names the task and stops.
+ * REFERENCE: FreeRTOS run time stats, uxTaskGetSystemState()
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4375116_reg_taskstats_timer_init() - start the run time counter (called by the scheduler)
+ * s4375116_taskstats_counter() - current value of the run time counter
+ * s4375116_taskstats_sample() - state of every task and the time it ran since the last sample
+ ***************************************************************
+ */
+
+#include "board.h"
+#include "processor_hal.h"
+#include "debug_log.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "s4375116_taskstats.h"
+
+// run time counter of each task at the previous sample, by task number
+static struct {
+	UBaseType_t number;
+	uint32_t runTime;
+} previous[TASKSTATS_MAX_TASKS];
+static int previousCount = 0;
+static uint32_t previousTotal = 0;
+
+/*
+ * Start the run time counter, called by vTaskStartScheduler() (portCONFIGURE_TIMER_FOR_RUN_TIME_STATS)
+ */
+void s4375116_reg_taskstats_timer_init(void) {
+
+	__TIM5_CLK_ENABLE();
+
+	// Set clock prescaler to 1MHz, the timer runs at twice the APB1 clock
+	TASKSTATS_TIMER->PSC = ((SystemCoreClock / 2) / TASKSTATS_COUNTER_FREQ) - 1;
+	TASKSTATS_TIMER->ARR = 0xFFFFFFFF;		// count through the whole 32 bits
+	TASKSTATS_TIMER->CNT = 0;
+	TASKSTATS_TIMER->EGR = TIM_EGR_UG;		// load the prescaler now
+	TASKSTATS_TIMER->CR1 |= TIM_CR1_CEN;
+}
+
+/*
+ * Current value of the run time counter (portGET_RUN_TIME_COUNTER_VALUE)
+ */
+uint32_t s4375116_taskstats_counter(void) {
+	return TASKSTATS_TIMER->CNT;
+}
+
+/**
+ * @brief Run time counter of a task at the previous sample, 0 for a new task
+ *
+ */
+uint32_t previous_run_time(UBaseType_t number) {
+
+	for (int i = 0; i < previousCount; i++) {
+		if (previous[i].number == number) {
+			return previous[i].runTime;
+		}
+	}
+	return 0;
+}
+
+/*
+ * Get the state of every task (at most max) and the counts each ran since the previous sample.
+ * elapsed returns the counts between the two samples. Returns the number of tasks
+ */
+int s4375116_taskstats_sample(TaskStatsTask *tasks, int max, uint32_t *elapsed) {
+
+	static TaskStatus_t status[TASKSTATS_MAX_TASKS];
+	uint32_t total;
+	int count;
+
+	count = uxTaskGetSystemState(status, TASKSTATS_MAX_TASKS, &total);
+
+	*elapsed = total - previousTotal;
+	previousTotal = total;
+
+	for (int i = 0; i < count && i < max; i++) {
+		tasks[i].status = status[i];
+		tasks[i].runTime = status[i].ulRunTimeCounter - previous_run_time(status[i].xTaskNumber);
+	}
+	for (int i = 0; i < count; i++) {
+		previous[i].number = status[i].xTaskNumber;
+		previous[i].runTime = status[i].ulRunTimeCounter;
+	}
+	previousCount = count;
+
+	return (count < max) ? count : max;
+}
+
+/*
+ * Called by the kernel when a task switched out with its stack overflowed (configCHECK_FOR_STACK_OVERFLOW).
+ * Nothing can be trusted any more, so the name goes straight out of the uart and everything stops.
+ */
+void vApplicationStackOverflowHook(TaskHandle_t xTask, char *pcTaskName) {
+
+	const char *text = "\r\nstack overflow: ";
+
+	taskDISABLE_INTERRUPTS();
+	BRD_LEDRedOn();
+
+	while (*text != '\0') {
+		debug_putc(*text++);
+	}
+	while (*pcTaskName != '\0') {
+		debug_putc(*pcTaskName++);
+	}
+	debug_putc('\r');
+	debug_putc('\n');
+
+	for (;;);
+}
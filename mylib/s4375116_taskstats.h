@@ -0,0 +1,41 @@
+ /**
+ **************************************************************
+ * @file mylib/s4375116_taskstats.h
+ * @author Sami Kaab - s4375116
+ * @date 19102026
+ * @brief Per task cpu use and stack use
+ * TIM5 (32 bit) free runs at TASKSTATS_COUNTER_FREQ as the FreeRTOS run time stats
+ * counter (portGET_RUN_TIME_COUNTER_VALUE in FreeRTOSConfig.h). A sample gives
+ * the counts each task ran since the previous sample, so the counter may wrap.
+ * configCHECK_FOR_STACK_OVERFLOW calls the hook here, which names the task and stops.
+ * REFERENCE: FreeRTOS run time stats, uxTaskGetSystemState()
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4375116_reg_taskstats_timer_init() - start the run time counter (called by the scheduler)
+ * s4375116_taskstats_counter() - current value of the run time counter
+ * s4375116_taskstats_sample() - state of every task and the time it ran since the last sample
+ ***************************************************************
+ */
+
+#ifndef S4375116_TASKSTATS_H
+#define S4375116_TASKSTATS_H
+
+#include <stdint.h>
+
+#define TASKSTATS_TIMER			TIM5		// 32 bit, free running
+#define TASKSTATS_COUNTER_FREQ	1000000		// Hz, 1 us per count
+#define TASKSTATS_MAX_TASKS		16
+
+// a task in a sample
+struct taskStatsTask {
+	TaskStatus_t status;	// stack high water mark in words
+	uint32_t runTime;		// counts the task ran since the previous sample
+};
+typedef struct taskStatsTask TaskStatsTask;
+
+void s4375116_reg_taskstats_timer_init(void);
+uint32_t s4375116_taskstats_counter(void);
+int s4375116_taskstats_sample(TaskStatsTask *tasks, int max, uint32_t *elapsed);
+
+#endif
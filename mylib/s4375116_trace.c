@@ -0,0 +1,249 @@
+ /**
+ **************************************************************
+ * @file mylib/s4375116_trace.c
+ * @author Sami Kaab - s4375116
+ * @date 19102026
+ * @brief Binary trace log, formatting deferred to a low priority task or the host
+ * TRACE_LOG(fmt, ...) stores the address of the format string, a cycle count stamp
+ * and up to four 32 bit arguments in a ring owned by the calling task. The trace
+ * task formats the records (text mode) or sends them as they are (binary mode)
+ * for host/trace_decode, which finds the format strings in the firmware ELF.
+ * Each ring has one writer (its task) and one reader (the trace task): the writer
+ * only moves the head and the reader only moves the tail, so logging takes no lock.
+ * A task gets its ring the first time it logs, kept in its thread local storage.
+ * The trace task merges the rings in stamp order.
+ * REFERENCE: ARMv7-M architecture reference manual (DWT_CYCCNT)
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4375116_trace_log() - record a message (use TRACE_LOG)
+ * s4375116_trace_mode() - set how the trace task outputs records
+ * s4375116_trace_dropped() - number of records lost because a ring was full
+ * s4375116_tsk_trace_init() - create the task that empties the rings
+ ***************************************************************
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "board.h"
+#include "processor_hal.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "s4375116_trace.h"
+#include "s4375116_uart_tx.h"
+
+struct traceRecord {
+	uint32_t stamp;		// DWT_CYCCNT when logged
+	const char *fmt;	// format string, also its id for the host decoder
+	uint32_t args[TRACE_MAX_ARGS];
+};
+
+struct traceRing {
+	struct traceRecord records[TRACE_RING_SIZE];
+	volatile uint32_t head;			// next free record, written by the owner task
+	volatile uint32_t tail;			// next record to output, written by the trace task
+	volatile unsigned long dropped;	// records lost to a full ring
+	char name[configMAX_TASK_NAME_LEN];
+	int announced;					// name sent in binary mode
+};
+
+static struct traceRing rings[TRACE_RINGS];
+static volatile int ringsUsed;
+static volatile unsigned long unassigned;	// records logged from interrupts or with no ring left
+static volatile int traceMode = TRACE_MODE_TEXT;
+static volatile int announce = 0;			// send the clock and task names before the next binary record
+
+/**
+ * @brief Give the calling task a ring, the one of a deleted task with the same name if there is one
+ * 
+ * @return struct traceRing* the ring, NULL if they are all taken
+ */
+struct traceRing *trace_ring_claim(void) {
+
+	struct traceRing *ring = NULL;
+	const char *name = pcTaskGetName(NULL);
+
+	taskENTER_CRITICAL();	// only once per task
+	for (int i = 0; i < ringsUsed; i++) {
+		if (strncmp(rings[i].name, name, configMAX_TASK_NAME_LEN) == 0) {
+			ring = &rings[i];
+		}
+	}
+	if (ring == NULL && ringsUsed < TRACE_RINGS) {
+		ring = &rings[ringsUsed];
+		strncpy(ring->name, name, configMAX_TASK_NAME_LEN - 1);
+		ringsUsed++;
+	}
+	taskEXIT_CRITICAL();
+
+	if (ring != NULL) {
+		vTaskSetThreadLocalStoragePointer(NULL, TRACE_TLS_INDEX, ring);
+	}
+	return ring;
+}
+
+/*
+ * Record a message in the ring of the calling task, use TRACE_LOG(fmt, ...).
+ * A few stores, the format string is not looked at. Not for interrupts.
+ */
+void s4375116_trace_log(const char *fmt, uint32_t a, uint32_t b, uint32_t c, uint32_t d) {
+
+	struct traceRing *ring;
+	struct traceRecord *record;
+	uint32_t head;
+
+	if (traceMode == TRACE_MODE_OFF) {
+		return;
+	}
+	if (__get_IPSR() != 0) {	// the ring belongs to whichever task was interrupted
+		unassigned++;
+		return;
+	}
+
+	ring = pvTaskGetThreadLocalStoragePointer(NULL, TRACE_TLS_INDEX);
+	if (ring == NULL && (ring = trace_ring_claim()) == NULL) {
+		unassigned++;
+		return;
+	}
+
+	head = ring->head;
+	if (head - ring->tail >= TRACE_RING_SIZE) {
+		ring->dropped++;
+		return;
+	}
+
+	record = &ring->records[head & (TRACE_RING_SIZE - 1)];
+	record->stamp = DWT->CYCCNT;
+	record->fmt = fmt;
+	record->args[0] = a;
+	record->args[1] = b;
+	record->args[2] = c;
+	record->args[3] = d;
+
+	__DMB();	// the record is complete before the trace task can see it
+	ring->head = head + 1;
+}
+
+/*
+ * Set how the trace task outputs records: TRACE_MODE_OFF, TRACE_MODE_TEXT or TRACE_MODE_BINARY
+ */
+void s4375116_trace_mode(int mode) {
+
+	if (mode == TRACE_MODE_BINARY) {
+		announce = 1;
+	}
+	traceMode = mode;
+}
+
+/*
+ * Number of records lost because a ring was full, no ring was left or they were logged from an interrupt
+ */
+unsigned long s4375116_trace_dropped(void) {
+
+	unsigned long total = unassigned;
+
+	for (int i = 0; i < ringsUsed; i++) {
+		total += rings[i].dropped;
+	}
+	return total;
+}
+
+/**
+ * @brief Send one record in the current mode
+ * 
+ * @param ring ring the record came from
+ * @param record copy of the record
+ */
+void trace_output(struct traceRing *ring, const struct traceRecord *record) {
+
+	char text[TRACE_TEXT_MAX];
+	int len;
+
+	if (traceMode == TRACE_MODE_TEXT) {
+		len = snprintf(text, sizeof(text), record->fmt, record->args[0], record->args[1], record->args[2], record->args[3]);
+
+	} else if (traceMode == TRACE_MODE_BINARY) {
+		if (!ring->announced) {
+			len = snprintf(text, sizeof(text), "#N %d %s\r\n", (int) (ring - rings), ring->name);
+			s4375116_uart_tx_write(text, len, portMAX_DELAY);
+			ring->announced = 1;
+		}
+		len = snprintf(text, sizeof(text), "#T %d %08lx %08lx %08lx %08lx %08lx %08lx\r\n", (int) (ring - rings),
+				(unsigned long) record->stamp, (unsigned long) (uint32_t) record->fmt,
+				(unsigned long) record->args[0], (unsigned long) record->args[1],
+				(unsigned long) record->args[2], (unsigned long) record->args[3]);
+	} else {
+		return;
+	}
+
+	if (len >= (int) sizeof(text)) {
+		len = sizeof(text) - 1;
+	}
+	// this task has the lowest priority, waiting for the uart holds up nobody
+	s4375116_uart_tx_write(text, len, portMAX_DELAY);
+}
+
+/**
+ * @brief Trace task, every TRACE_DRAIN_PERIOD_MS empties the rings, oldest record first
+ * 
+ */
+void s4375116TaskTrace(void) {
+
+	struct traceRing *oldest;
+	struct traceRecord *record;
+	struct traceRecord copy;
+	char text[32];
+	int len;
+
+	// stamps come from the cycle counter (also used by s4375116_latency.c, started here without a reset)
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	for (;;) {
+
+		vTaskDelay(TRACE_DRAIN_PERIOD_MS);
+
+		if (announce && traceMode == TRACE_MODE_BINARY) {
+			len = snprintf(text, sizeof(text), "#F %lu\r\n", (unsigned long) SystemCoreClock);
+			s4375116_uart_tx_write(text, len, portMAX_DELAY);
+			for (int i = 0; i < ringsUsed; i++) {
+				rings[i].announced = 0;
+			}
+			announce = 0;
+		}
+
+		for (;;) {
+			oldest = NULL;
+			for (int i = 0; i < ringsUsed; i++) {
+				if (rings[i].head != rings[i].tail && (oldest == NULL ||
+						(int32_t) (rings[i].records[rings[i].tail & (TRACE_RING_SIZE - 1)].stamp -
+						oldest->records[oldest->tail & (TRACE_RING_SIZE - 1)].stamp) < 0)) {
+					oldest = &rings[i];
+				}
+			}
+			if (oldest == NULL) {
+				break;
+			}
+
+			__DMB();	// read the record only after seeing the head that covers it
+			record = &oldest->records[oldest->tail & (TRACE_RING_SIZE - 1)];
+			copy = *record;
+			__DMB();	// done with the record before the owner may reuse it
+			oldest->tail++;
+
+			trace_output(oldest, &copy);
+		}
+	}
+}
+
+/*
+ * Create the task that empties the trace rings
+ */
+void s4375116_tsk_trace_init(void) {
+
+	xTaskCreate( (void *) &s4375116TaskTrace, (const signed char *) "TRACE", TRACETASK_STACK_SIZE, NULL, TRACETASK_PRIORITY, NULL );
+
+}
@@ -0,0 +1,55 @@
+ /**
+ **************************************************************
+ * @file mylib/s4375116_trace.h
+ * @author Sami Kaab - s4375116
+ * @date 19102026
+ * @brief Binary trace log, formatting deferred to a low priority task or the host
+ * TRACE_LOG(fmt, ...) stores the address of the format string, a cycle count stamp
+ * and up to four 32 bit arguments in a ring owned by the calling task. The trace
+ * task formats the records (text mode) or sends them as they are (binary mode)
+ * for host/trace_decode, which finds the format strings in the firmware ELF.
+ * Arguments: integers and characters, %s only for strings that never change
+ * (string literals). No floating point or 64 bit values.
+ * REFERENCE: ARMv7-M architecture reference manual (DWT_CYCCNT)
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4375116_trace_log() - record a message (use TRACE_LOG)
+ * s4375116_trace_mode() - set how the trace task outputs records
+ * s4375116_trace_dropped() - number of records lost because a ring was full
+ * s4375116_tsk_trace_init() - create the task that empties the rings
+ ***************************************************************
+ */
+
+#ifndef S4375116_TRACE_H
+#define S4375116_TRACE_H
+
+#include <stdint.h>
+
+#define TRACE_RINGS				8		// tasks that can log
+#define TRACE_RING_SIZE			32		// records per task, must be a power of 2
+#define TRACE_MAX_ARGS			4
+#define TRACE_TLS_INDEX			0		// thread local storage pointer holding the ring of a task
+#define TRACE_DRAIN_PERIOD_MS	50		// time between passes of the trace task
+#define TRACE_TEXT_MAX			128		// longest formatted message
+
+#define TRACE_MODE_OFF			0		// records are discarded
+#define TRACE_MODE_TEXT			1		// formatted on the board
+#define TRACE_MODE_BINARY		2		// "#T" lines for host/trace_decode
+
+// Task Priorities (Idle Priority is the lowest priority)
+#define TRACETASK_PRIORITY		( tskIDLE_PRIORITY + 1 )
+// Task Stack Allocations (must be a multiple of the minimal stack size)
+#define TRACETASK_STACK_SIZE	( configMINIMAL_STACK_SIZE * 3 )
+
+// record a message from a task, unused arguments are filled with 0
+#define TRACE_LOG(...)		trace_log_args(__VA_ARGS__, 0, 0, 0, 0)
+#define trace_log_args(fmt, a, b, c, d, ...) \
+	s4375116_trace_log(fmt, (uint32_t) (a), (uint32_t) (b), (uint32_t) (c), (uint32_t) (d))
+
+void s4375116_trace_log(const char *fmt, uint32_t a, uint32_t b, uint32_t c, uint32_t d);
+void s4375116_trace_mode(int mode);
+unsigned long s4375116_trace_dropped(void);
+void s4375116_tsk_trace_init(void);
+
+#endif
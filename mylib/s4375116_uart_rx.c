@@ -0,0 +1,132 @@
+ /**
+ **************************************************************
+ * @file mylib/s4375116_uart_rx.c
+ * @author Sami Kaab - s4375116
+ * @date 19102026
+ * @brief Interrupt driven receive for the debug uart
+ * Every received byte is put in a ring buffer by the USART RXNE interrupt and the
+ * reader task is woken by setting UART_RX_NOTIFY_BIT in its notification value, so
+ * nothing polls the uart. The interrupt only writes the head and the reader only
+ * writes the tail, so the ring needs no lock between them.
+ * REFERENCE: STM32F429 reference manual (RM0090) USART chapter
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4375116_reg_uart_rx_init() - enable the receive interrupt of the debug uart
+ * s4375116_uart_rx_set_reader() - set the task notified when a character is received
+ * s4375116_uart_rx_read() - take the next received character without waiting
+ * s4375116_uart_rx_getc() - wait for the next received character
+ * s4375116_uart_rx_dropped() - number of characters lost because the ring was full
+ ***************************************************************
+ */
+
+#include "board.h"
+#include "processor_hal.h"
+#include "debug_log.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "s4375116_uart_rx.h"
+
+static volatile uint8_t ring[UART_RX_RING_SIZE];
+static volatile uint32_t ringHead;			// next free slot, written by the isr
+static volatile uint32_t ringTail;			// next character to read, written by the reader
+static volatile unsigned long dropped;		// characters lost to a full ring
+static volatile TaskHandle_t reader = NULL;	// task notified of received characters
+
+/*
+ * Enable the receive interrupt of the debug uart, the uart itself is set up by BRD_debuguart_init()
+ */
+void s4375116_reg_uart_rx_init(void) {
+
+	// Drop anything received before the interrupt was enabled
+	(void) UART_RX_USART->SR;
+	(void) UART_RX_USART->DR;
+
+	UART_RX_USART->CR1 |= USART_CR1_RXNEIE;	//Interrupt on each received byte (and overrun)
+
+	//Enable priority (10) and interrupt callback. Do not set a priority lower than 5.
+	HAL_NVIC_SetPriority(UART_RX_IRQ, 10, 0);
+	HAL_NVIC_EnableIRQ(UART_RX_IRQ);
+}
+
+/*
+ * Set the task notified (UART_RX_NOTIFY_BIT) when a character is received
+ */
+void s4375116_uart_rx_set_reader(TaskHandle_t task) {
+	reader = task;
+}
+
+/*
+ * Take the next received character without waiting, returns 0 if the ring is empty
+ */
+int s4375116_uart_rx_read(char *c) {
+
+	if (ringTail == ringHead) {
+		return 0;
+	}
+	*c = ring[ringTail & (UART_RX_RING_SIZE - 1)];
+	ringTail++;
+	return 1;
+}
+
+/*
+ * Wait up to timeout ticks for the next received character, returns '\0' if none arrived.
+ * The calling task becomes the reader.
+ */
+char s4375116_uart_rx_getc(TickType_t timeout) {
+
+	char c;
+
+	reader = xTaskGetCurrentTaskHandle();
+
+	while (!s4375116_uart_rx_read(&c)) {
+		if (xTaskNotifyWait(0, UART_RX_NOTIFY_BIT, NULL, timeout) == pdFALSE) {
+			return '\0';
+		}
+	}
+	return c;
+}
+
+/*
+ * Number of characters lost because the ring was full
+ */
+unsigned long s4375116_uart_rx_dropped(void) {
+	return dropped;
+}
+
+/*
+ * Interrupt handler (ISR) for the debug uart, only the receive interrupt is enabled
+ */
+void USART3_IRQHandler(void) {
+
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+	uint32_t status = UART_RX_USART->SR;
+	uint8_t data;
+
+	NVIC_ClearPendingIRQ(UART_RX_IRQ);
+
+	// Reading SR then DR clears RXNE and the overrun flag
+	if (status & (USART_SR_RXNE | USART_SR_ORE)) {
+
+		data = UART_RX_USART->DR;
+
+		if (ringHead - ringTail < UART_RX_RING_SIZE) {
+			ring[ringHead & (UART_RX_RING_SIZE - 1)] = data;
+			ringHead++;
+		} else {
+			dropped++;
+		}
+		if (status & USART_SR_ORE) {	// a byte was overwritten in the data register
+			dropped++;
+		}
+
+		if (reader != NULL) {
+			xTaskNotifyFromISR(reader, UART_RX_NOTIFY_BIT, eSetBits, &xHigherPriorityTaskWoken);
+		}
+	}
+
+	// Perform context switching, if required.
+	portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+}
@@ -0,0 +1,35 @@
+ /**
+ **************************************************************
+ * @file mylib/s4375116_uart_rx.h
+ * @author Sami Kaab - s4375116
+ * @date 19102026
+ * @brief Interrupt driven receive for the debug uart
+ * Every received byte is put in a ring buffer by the USART RXNE interrupt and the
+ * reader task is woken with a task notification, so nothing polls the uart.
+ * REFERENCE: STM32F429 reference manual (RM0090) USART chapter
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4375116_reg_uart_rx_init() - enable the receive interrupt of the debug uart
+ * s4375116_uart_rx_set_reader() - set the task notified when a character is received
+ * s4375116_uart_rx_read() - take the next received character without waiting
+ * s4375116_uart_rx_getc() - wait for the next received character
+ * s4375116_uart_rx_dropped() - number of characters lost because the ring was full
+ ***************************************************************
+ */
+
+#ifndef S4375116_UART_RX_H
+#define S4375116_UART_RX_H
+
+#define UART_RX_USART		USART3		// debug uart (st-link virtual com port)
+#define UART_RX_IRQ			USART3_IRQn
+#define UART_RX_RING_SIZE	256			// must be a power of 2
+#define UART_RX_NOTIFY_BIT	(1UL << 0)	// notification bit set in the reader task
+
+void s4375116_reg_uart_rx_init(void);
+void s4375116_uart_rx_set_reader(TaskHandle_t task);
+int s4375116_uart_rx_read(char *c);
+char s4375116_uart_rx_getc(TickType_t timeout);
+unsigned long s4375116_uart_rx_dropped(void);
+
+#endif
@@ -0,0 +1,220 @@
+ /**
+ **************************************************************
+ * @file mylib/s4375116_uart_tx.c
+ * @author Sami Kaab - s4375116
+ * @date 19102026
+ * @brief DMA driven transmit for the debug uart
+ * Output is copied into a ring buffer and sent by DMA1 Stream 3 in the background,
+ * so writers only wait when they ask to and the ring is full. Writers take a mutex
+ * to append (never held longer than a copy), only the transfer complete interrupt
+ * moves the tail, and the transfer of the next contiguous part of the ring is
+ * started either by the writer (DMA idle) or by that interrupt (DMA busy).
+ * Before s4375116_reg_uart_tx_init() output goes straight to the uart with debug_putc().
+ * REFERENCE: STM32F429 reference manual (RM0090) USART and DMA chapters
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4375116_reg_uart_tx_init() - set up the transmit DMA of the debug uart
+ * s4375116_uart_tx_write() - queue bytes for transmission
+ * s4375116_uart_tx_printf() - queue formatted log output
+ * s4375116_uart_tx_dropped() - number of bytes lost because the ring was full
+ ***************************************************************
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "board.h"
+#include "processor_hal.h"
+#include "debug_log.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+#include "s4375116_uart_tx.h"
+
+static char ring[UART_TX_RING_SIZE];
+static volatile uint32_t ringHead;			// next free slot, written by writers holding txMutex
+static volatile uint32_t ringTail;			// next byte to send, written by the dma interrupt
+static volatile uint32_t dmaLength;			// bytes of the running transfer, 0 when the dma is idle
+static volatile unsigned long dropped;		// bytes lost to a full ring
+static SemaphoreHandle_t txMutex = NULL;	// one writer at a time
+static SemaphoreHandle_t txSpace = NULL;	// given each time a transfer completes
+
+/**
+ * @brief Start sending the next contiguous part of the ring, the dma must be idle
+ * 
+ */
+void uart_tx_start(void) {
+
+	uint32_t offset = ringTail & (UART_TX_RING_SIZE - 1);
+	uint32_t length = ringHead - ringTail;
+
+	if (length == 0) {
+		return;
+	}
+	if (length > UART_TX_RING_SIZE - offset) {	// stop at the end of the ring, the rest goes next
+		length = UART_TX_RING_SIZE - offset;
+	}
+	dmaLength = length;
+
+	DMA1->LIFCR = DMA_LIFCR_CTCIF3 | DMA_LIFCR_CHTIF3 | DMA_LIFCR_CTEIF3 | DMA_LIFCR_CDMEIF3 | DMA_LIFCR_CFEIF3;
+	UART_TX_DMA->M0AR = (uint32_t) &ring[offset];
+	UART_TX_DMA->NDTR = length;
+	UART_TX_DMA->CR |= DMA_SxCR_EN;
+}
+
+/*
+ * Set up the transmit DMA of the debug uart, the uart itself is set up by BRD_debuguart_init()
+ */
+void s4375116_reg_uart_tx_init(void) {
+
+	txMutex = xSemaphoreCreateMutex();
+	txSpace = xSemaphoreCreateBinary();
+
+	__DMA1_CLK_ENABLE();	//Enable DMA1 clock
+
+	// DMA1 Stream 3 channel 4 (USART3_TX): ring -> data register, a byte at a time
+	UART_TX_DMA->CR &= ~DMA_SxCR_EN;
+	while (UART_TX_DMA->CR & DMA_SxCR_EN);
+	UART_TX_DMA->CR = DMA_SxCR_CHSEL_2 |	// channel 4
+			DMA_SxCR_MINC |					// step through the ring
+			DMA_SxCR_DIR_0 |				// memory to peripheral
+			DMA_SxCR_TCIE | DMA_SxCR_TEIE;	// interrupt at the end of each transfer
+	UART_TX_DMA->PAR = (uint32_t) &UART_TX_USART->DR;
+	UART_TX_DMA->FCR = 0;					// direct mode
+
+	UART_TX_USART->CR3 |= USART_CR3_DMAT;	// TXE requests the next byte from the dma
+
+	//Enable priority (10) and interrupt callback. Do not set a priority lower than 5.
+	HAL_NVIC_SetPriority(UART_TX_DMA_IRQ, 10, 0);
+	HAL_NVIC_EnableIRQ(UART_TX_DMA_IRQ);
+}
+
+/*
+ * Queue len bytes for transmission. If the ring is full the writer waits up to wait ticks
+ * for space, with no wait a write that does not fit is dropped whole.
+ * Interrupts cannot wait for the mutex, their output is dropped.
+ * Returns the number of bytes queued
+ */
+int s4375116_uart_tx_write(const char *buf, int len, TickType_t wait) {
+
+	int written = 0;
+	uint32_t space;
+	uint32_t offset;
+	uint32_t count;
+
+	if (txMutex == NULL || xTaskGetSchedulerState() != taskSCHEDULER_RUNNING) {
+		// not set up yet, send it the slow way
+		for (int i = 0; i < len; i++) {
+			debug_putc(buf[i]);
+		}
+		debug_flush();
+		return len;
+	}
+	if (__get_IPSR() != 0) {
+		dropped += len;
+		return 0;
+	}
+
+	xSemaphoreTake(txMutex, portMAX_DELAY);
+
+	while (written < len) {
+
+		space = UART_TX_RING_SIZE - (ringHead - ringTail);
+
+		if (space == 0 || (wait == 0 && space < (uint32_t) (len - written))) {
+			// the interrupt gives txSpace after each transfer, look again then
+			if (wait == 0 || xSemaphoreTake(txSpace, wait) != pdTRUE) {
+				dropped += len - written;
+				break;
+			}
+			continue;
+		}
+
+		// copy what fits, in two parts if it wraps around the end of the ring
+		count = len - written;
+		if (count > space) {
+			count = space;
+		}
+		offset = ringHead & (UART_TX_RING_SIZE - 1);
+		if (count > UART_TX_RING_SIZE - offset) {
+			memcpy(&ring[offset], buf + written, UART_TX_RING_SIZE - offset);
+			memcpy(&ring[0], buf + written + (UART_TX_RING_SIZE - offset), count - (UART_TX_RING_SIZE - offset));
+		} else {
+			memcpy(&ring[offset], buf + written, count);
+		}
+		ringHead += count;
+		written += count;
+
+		// an idle dma has no interrupt coming that would start it
+		if (dmaLength == 0) {
+			uart_tx_start();
+		}
+	}
+
+	xSemaphoreGive(txMutex);
+	return written;
+}
+
+/*
+ * Queue formatted log output, follows the UART_TX_LOG_WAIT overflow policy.
+ * Messages longer than UART_TX_PRINTF_MAX are cut short
+ */
+int s4375116_uart_tx_printf(const char *fmt, ...) {
+
+	char text[UART_TX_PRINTF_MAX];
+	va_list args;
+	int len;
+
+	va_start(args, fmt);
+	len = vsnprintf(text, sizeof(text), fmt, args);
+	va_end(args);
+
+	if (len < 0) {
+		return 0;
+	} else if (len >= (int) sizeof(text)) {
+		len = sizeof(text) - 1;
+	}
+	return s4375116_uart_tx_write(text, len, UART_TX_LOG_WAIT);
+}
+
+/*
+ * Number of bytes lost because the ring was full
+ */
+unsigned long s4375116_uart_tx_dropped(void) {
+	return dropped;
+}
+
+/*
+ * Interrupt handler (ISR) for the transmit DMA, frees the bytes just sent and starts the next part
+ */
+void DMA1_Stream3_IRQHandler(void) {
+
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+	uint32_t status = DMA1->LISR;
+
+	NVIC_ClearPendingIRQ(UART_TX_DMA_IRQ);
+
+	if (status & (DMA_LISR_TCIF3 | DMA_LISR_TEIF3)) {
+
+		DMA1->LIFCR = DMA_LIFCR_CTCIF3 | DMA_LIFCR_CTEIF3;
+
+		if (status & DMA_LISR_TEIF3) {	// transfer error, the part is lost
+			dropped += UART_TX_DMA->NDTR;
+		}
+
+		ringTail += dmaLength;
+		dmaLength = 0;
+		uart_tx_start();
+
+		if (txSpace != NULL) {
+			xSemaphoreGiveFromISR(txSpace, &xHigherPriorityTaskWoken);
+		}
+	}
+
+	// Perform context switching, if required.
+	portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+}
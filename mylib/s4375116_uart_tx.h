@@ -0,0 +1,38 @@
+ /**
+ **************************************************************
+ * @file mylib/s4375116_uart_tx.h
+ * @author Sami Kaab - s4375116
+ * @date 19102026
+ * @brief DMA driven transmit for the debug uart
+ * Output is copied into a ring buffer and sent by DMA1 Stream 3 in the background,
+ * so writers only wait when they ask to and the ring is full.
+ * REFERENCE: STM32F429 reference manual (RM0090) USART and DMA chapters
+ ***************************************************************
+ * EXTERNAL FUNCTIONS
+ ***************************************************************
+ * s4375116_reg_uart_tx_init() - set up the transmit DMA of the debug uart
+ * s4375116_uart_tx_write() - queue bytes for transmission
+ * s4375116_uart_tx_printf() - queue formatted log output
+ * s4375116_uart_tx_dropped() - number of bytes lost because the ring was full
+ ***************************************************************
+ */
+
+#ifndef S4375116_UART_TX_H
+#define S4375116_UART_TX_H
+
+#define UART_TX_USART		USART3			// debug uart (st-link virtual com port)
+#define UART_TX_DMA			DMA1_Stream3	// channel 4 is USART3_TX
+#define UART_TX_DMA_IRQ		DMA1_Stream3_IRQn
+#define UART_TX_RING_SIZE	2048			// must be a power of 2
+#define UART_TX_PRINTF_MAX	128				// longest formatted message
+
+// overflow policy of s4375116_uart_tx_printf(): 0 drops a message that does not fit,
+// otherwise the most ticks a writer waits for space (portMAX_DELAY blocks)
+#define UART_TX_LOG_WAIT	0
+
+void s4375116_reg_uart_tx_init(void);
+int s4375116_uart_tx_write(const char *buf, int len, TickType_t wait);
+int s4375116_uart_tx_printf(const char *fmt, ...);
+unsigned long s4375116_uart_tx_dropped(void);
+
+#endif
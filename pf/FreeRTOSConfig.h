@@ -87,6 +87,8 @@
 #if defined(__ICCARM__) || defined(__CC_ARM) || defined(__GNUC__)
  #include <stdint.h>
  extern uint32_t SystemCoreClock;
+ extern void s4375116_reg_taskstats_timer_init(void);
+ extern uint32_t s4375116_taskstats_counter(void);
 #endif
 
 #define configCOMMAND_INT_MAX_OUTPUT_SIZE			100
@@ -106,16 +108,21 @@
 #define configUSE_QUEUE_SETS			  1
 #define configUSE_MUTEXES                 1
 #define configQUEUE_REGISTRY_SIZE         8
-#define configCHECK_FOR_STACK_OVERFLOW    0
+#define configCHECK_FOR_STACK_OVERFLOW    2
 #define configUSE_RECURSIVE_MUTEXES       1
 #define configUSE_MALLOC_FAILED_HOOK      0
 #define configUSE_APPLICATION_TASK_TAG    0
+#define configNUM_THREAD_LOCAL_STORAGE_POINTERS 1
 #define configUSE_COUNTING_SEMAPHORES     1
-#define configGENERATE_RUN_TIME_STATS     0
+#define configGENERATE_RUN_TIME_STATS     1
 #define configUSE_TASK_NOTIFICATIONS      1
 #define configTASK_NOTIFICATION_ARRAY_ENTRIES   1
 #define configSUPPORT_DYNAMIC_ALLOCATION    1
 
+/* Run time stats count TIM5 at 1MHz, see s4375116_taskstats.c */
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()	s4375116_reg_taskstats_timer_init()
+#define portGET_RUN_TIME_COUNTER_VALUE()			s4375116_taskstats_counter()
+
 
 /* Co-routine definitions. */
 #define configUSE_CO_ROUTINES           0
@@ -19,16 +19,31 @@ CFLAGS += -I$(MYLIB_PATH)
 # DO NOT USE absolute file paths (e.g. /home/users/myuser/mydir)
 LIBSRCS += $(MYLIB_PATH)/s4375116_lta1000g.c
 LIBSRCS += $(MYLIB_PATH)/s4375116_joystick.c
+LIBSRCS += $(MYLIB_PATH)/s4375116_joystick_cal.c
+LIBSRCS += $(MYLIB_PATH)/s4375116_debounce.c
 LIBSRCS += $(MYLIB_PATH)/s4375116_pantilt.c
 LIBSRCS += $(MYLIB_PATH)/s4375116_hamming.c
 LIBSRCS += $(MYLIB_PATH)/s4375116_irremote.c
 LIBSRCS += $(MYLIB_PATH)/s4375116_oled.c
+LIBSRCS += $(MYLIB_PATH)/s4375116_oled_fb.c
 LIBSRCS += $(MYLIB_PATH)/s4375116_CAG_display.c
+LIBSRCS += $(MYLIB_PATH)/s4375116_CAG_render.c
+LIBSRCS += $(MYLIB_PATH)/s4375116_CAG_recorder.c
+LIBSRCS += $(MYLIB_PATH)/s4375116_CAG_term.c
 LIBSRCS += $(MYLIB_PATH)/s4375116_CAG_simulator.c
+LIBSRCS += $(MYLIB_PATH)/s4375116_CAG_proto.c
+LIBSRCS += $(MYLIB_PATH)/s4375116_CAG_link.c
 LIBSRCS += $(MYLIB_PATH)/s4375116_CAG_grid.c
 LIBSRCS += $(MYLIB_PATH)/s4375116_CAG_joystick.c
 LIBSRCS += $(MYLIB_PATH)/s4375116_cli_mnemonic.c
 LIBSRCS += $(MYLIB_PATH)/s4375116_cli_task.c
+LIBSRCS += $(MYLIB_PATH)/s4375116_uart_rx.c
+LIBSRCS += $(MYLIB_PATH)/s4375116_uart_tx.c
+LIBSRCS += $(MYLIB_PATH)/s4375116_console.c
+LIBSRCS += $(MYLIB_PATH)/s4375116_latency.c
+LIBSRCS += $(MYLIB_PATH)/s4375116_trace.c
+LIBSRCS += $(MYLIB_PATH)/s4375116_taskstats.c
+LIBSRCS += $(MYLIB_PATH)/s4375116_bench.c
 LIBSRCS += $(MYLIB_PATH)/s4375116_CAG_mnemonic.c
 
 
@@ -26,6 +26,10 @@
 #include "s4375116_cli_mnemonic.h"
 #include "s4375116_cli_task.h"
 #include "s4375116_CAG_mnemonic.h"
+#include "s4375116_uart_rx.h"
+#include "s4375116_uart_tx.h"
+#include "s4375116_console.h"
+#include "s4375116_trace.h"
 /*
  * Main program
  */
@@ -35,12 +39,13 @@ int main(void) {
 
 	s4375116_tsk_cag_simulator_init();
 	s4375116_tsk_cag_display_init();
-	s4375116_tsk_cag_grid_init();
+	s4375116_joystick_set_log(s4375116_uart_tx_printf);	// the uart belongs to the tx ring
 	s4375116_tsk_joystick_init();
 	s4375116_tsk_cag_joystick_init();
 
-	s4375116_cli_init();
+	s4375116_tsk_console_init();	// grid keys and cli input
 	s4375116_tsk_cag_mnemonic_init();
+	s4375116_tsk_trace_init();		// formats TRACE_LOG messages
 
 	/* Start the scheduler.
 
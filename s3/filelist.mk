@@ -19,6 +19,8 @@ CFLAGS += -I$(MYLIB_PATH)
 # DO NOT USE absolute file paths (e.g. /home/users/myuser/mydir)
 LIBSRCS += $(MYLIB_PATH)/s4375116_lta1000g.c
 LIBSRCS += $(MYLIB_PATH)/s4375116_joystick.c
+LIBSRCS += $(MYLIB_PATH)/s4375116_joystick_cal.c
+LIBSRCS += $(MYLIB_PATH)/s4375116_debounce.c
 LIBSRCS += $(MYLIB_PATH)/s4375116_pantilt.c
 LIBSRCS += $(MYLIB_PATH)/s4375116_hamming.c
 LIBSRCS += $(MYLIB_PATH)/s4375116_irremote.c
@@ -23,13 +23,14 @@
 void hardware_init(void);
 int fsm_processing(int currState, char lastChar, char currChar);
 uint8_t process_inputs(int lastChar, int currChar);
+HammingStatus decode_and_log(const char *source, uint8_t value, unsigned char *data);
 
 
 int main(void)  {
   
-	uint16_t codedWord, decodeByte;
-  int parity; // parity error from decode
-  int error;  // one bit error from decode
+	uint16_t codedWord;
+  unsigned char decodeByte;
+  HammingStatus status = HAMMING_CLEAN; // error found by the last decode
   int currState = S0, lastState; 
   char lastChar = '\0', currChar; // last and current char entered via keyboard
   char lastIRChar = '\0', currIRChar; // last and current char entered via ir remote
@@ -87,19 +88,7 @@ int main(void)  {
           if (currState == S3) {
         
             // Hamming decode received character 
-            decodeByte = s4375116_lib_hamming_byte_decode(irx);
-
-            parity = s4375116_lib_hamming_parity_error(irx);
-
-            /* check if the byte had a bit reversal (error) 
-               1-bit error -> 0x1, parity check error -> 0x2, 2-bit (parity and error) -> 0x2 
-             */
-            if (!parity) {
-              error = !(((x & 0xF0)>>4) == decodeByte);
-            } else {
-              error = 0;
-            }
-            debug_log("ir value 0x%02x decoded is 0x%x\n\r", irx, error | (parity << 1) | (irx << 2));
+            status = decode_and_log("ir", irx, &decodeByte);
           }
         }
 
@@ -129,8 +118,7 @@ int main(void)  {
             // Reset values
             decodeByte = 0;
             codedWord = 0;
-            error = 0;
-            parity = 0;
+            status = HAMMING_CLEAN;
           } else {
 
             // Check received chars are correct and concatenate them into hex number
@@ -145,19 +133,7 @@ int main(void)  {
             } else if (currState ==  S2) { //decode state
             
               // Hamming decode received character 
-              decodeByte = s4375116_lib_hamming_byte_decode(x);
-              parity = s4375116_lib_hamming_parity_error(x);
-              
-              /* check if the byte had a bit reversal (error) 
-                1-bit error -> 0x1, parity check error -> 0x2, 2-bit (parity and error) -> 0x2 
-              */
-              if (!parity) {
-                error = !(((x & 0xF0)>>4) == decodeByte);
-              } else {
-                error = 0;
-              }
-              
-              debug_log("console value 0x%02x decoded is 0x%x\n\r", x, decodeByte);
+              status = decode_and_log("console", x, &decodeByte);
             }
           }
         }
@@ -171,8 +147,8 @@ int main(void)  {
         led_val = (codedWord >> (8 * ((press_counter + 1)%2))) & 0xFF;
       } else if (currState == S2) { // decode state
       
-        // display data on LED segment 0 to 3, and error bit and parity check on LED Segment 8 and 9
-        led_val = decodeByte | parity << 9 | error << 8;
+        // display data on LED segment 0 to 3, a corrected 1-bit error on segment 8 and a 2-bit error on segment 9
+        led_val = decodeByte | (status == HAMMING_CORRECTED) << 8 | (status == HAMMING_DOUBLE) << 9;
       } else { // turn of every led bar if not in S1 or S2
 
         led_val = 0;
@@ -245,6 +221,29 @@ uint8_t process_inputs(int lastChar, int currChar) {
   return x;
 }
 
+/**
+ * @brief Hamming decode a coded byte and print the data with the error found
+ * 
+ * @param source where the byte came from
+ * @param value coded byte
+ * @param data returns the decoded 4 bits
+ * @return HammingStatus clean, 1-bit error corrected or 2-bit error detected
+ */
+HammingStatus decode_and_log(const char *source, uint8_t value, unsigned char *data) {
+
+  int bit;
+  HammingStatus status = s4375116_lib_hamming_decode(value, data, &bit);
+
+  if (status == HAMMING_CORRECTED) {
+    debug_log("%s value 0x%02x decoded is 0x%x, bit %d corrected\n\r", source, value, *data, bit);
+  } else if (status == HAMMING_DOUBLE) {
+    debug_log("%s value 0x%02x decoded is 0x%x, 2-bit error\n\r", source, value, *data);
+  } else {
+    debug_log("%s value 0x%02x decoded is 0x%x\n\r", source, value, *data);
+  }
+  return status;
+}
+
 /*
  * returns next state base on current state and last two consol iputs
  */
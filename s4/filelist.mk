@@ -19,10 +19,13 @@ CFLAGS += -I$(MYLIB_PATH)
 # DO NOT USE absolute file paths (e.g. /home/users/myuser/mydir)
 LIBSRCS += $(MYLIB_PATH)/s4375116_lta1000g.c
 LIBSRCS += $(MYLIB_PATH)/s4375116_joystick.c
+LIBSRCS += $(MYLIB_PATH)/s4375116_joystick_cal.c
+LIBSRCS += $(MYLIB_PATH)/s4375116_debounce.c
 LIBSRCS += $(MYLIB_PATH)/s4375116_pantilt.c
 LIBSRCS += $(MYLIB_PATH)/s4375116_hamming.c
 LIBSRCS += $(MYLIB_PATH)/s4375116_irremote.c
 LIBSRCS += $(MYLIB_PATH)/s4375116_oled.c
+LIBSRCS += $(MYLIB_PATH)/s4375116_oled_fb.c
 
 # Including memory heap model
 LIBSRCS += $(FREERTOS_PATH)/portable/MemMang/heap_1.c